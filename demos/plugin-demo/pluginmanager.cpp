@@ -616,7 +616,8 @@ void PluginManager::restoreSettings() {
 
     // TODO - use the global config API
 
-    // main window state
+    // main window state, the toolbars must exist before restoring it
+    flushGUI();
     settingsManager->beginGroup("mainwindow");
     {
         restoreState(settingsManager->value("state").toByteArray());
@@ -635,6 +636,7 @@ void PluginManager::restoreSettings() {
     // restore opened files
     settingsManager->beginGroup("files");
     {
+        auto guard = qmdiUpdateGuard(this);
         for (auto &s : settingsManager->childKeys()) {
             if (!s.startsWith("file")) {
                 continue;
@@ -1050,8 +1052,6 @@ void PluginManager::enablePlugin(IPlugin *plugin) {
     if (plugin->enabled) {
         plugin->setEnabled(true);
         mergeClient(plugin);
-        plugin->menus.addActionsToWidget(this);
-        plugin->toolbars.addActionsToWidget(this);
     }
 }
 
@@ -1123,35 +1123,38 @@ void PluginManager::disablePlugin(IPlugin *plugin) {
  * \todo add methods for adding/removing menus in a more sane way
  */
 void PluginManager::initGUI() {
-    menus[tr("&File")]->addAction(actionNewFile);
-    menus[tr("&File")]->addAction(actionOpen);
-    menus[tr("&File")]->addMenu(closedDocumentsMenu);
-    menus[tr("&File")]->addSeparator();
-    menus[tr("&File")]->setMergePoint();
-    menus[tr("&File")]->addAction(actionClose);
-    menus[tr("&File")]->addAction(actionCloseAll);
-    menus[tr("&File")]->addAction(actionCloseOthers);
-    menus[tr("&File")]->addSeparator();
-    menus[tr("&File")]->addAction(actionQuit);
-    menus[tr("&Edit")];
-    menus[tr("&Search")];
-    menus[tr("&View")];
-    menus[tr("&Project")];
-    menus[tr("&Build")];
-    menus[tr("&Debug")];
-    menus[tr("&Navigation")];
-    menus[tr("&Tools")];
-    menus[tr("Se&ttings")]->addAction(actionConfig);
-    menus[tr("Se&ttings")]->addAction(showDocksAction);
-    menus[tr("Se&ttings")]->setMergePoint();
-    menus[tr("Se&ttings")]->addSeparator();
-    menus[tr("Se&ttings")]->addAction(actionNextTab);
-    menus[tr("Se&ttings")]->addAction(actionPrevTab);
-    menus[tr("Se&ttings")]->addAction(actionHideGUI);
-    menus[tr("Se&ttings")]->addAction(actionMoveTabLeft);
-    menus[tr("Se&ttings")]->addAction(actionMoveTabRight);
-    menus[tr("&Window")];
-    menus[tr("&Help")];
+    static constexpr auto menuLayout = qmdiActionGroupLayout(
+        QT_TRANSLATE_NOOP("PluginManager", "&File"), QT_TRANSLATE_NOOP("PluginManager", "&Edit"),
+        QT_TRANSLATE_NOOP("PluginManager", "&Search"), QT_TRANSLATE_NOOP("PluginManager", "&View"),
+        QT_TRANSLATE_NOOP("PluginManager", "&Project"),
+        QT_TRANSLATE_NOOP("PluginManager", "&Build"), QT_TRANSLATE_NOOP("PluginManager", "&Debug"),
+        QT_TRANSLATE_NOOP("PluginManager", "&Navigation"),
+        QT_TRANSLATE_NOOP("PluginManager", "&Tools"),
+        QT_TRANSLATE_NOOP("PluginManager", "Se&ttings"),
+        QT_TRANSLATE_NOOP("PluginManager", "&Window"), QT_TRANSLATE_NOOP("PluginManager", "&Help"));
+    static constexpr auto fileMenu = menuLayout.slot("&File");
+    static constexpr auto settingsMenu = menuLayout.slot("Se&ttings");
+
+    auto m = menuLayout.apply(menus, "PluginManager");
+    m[fileMenu]->addAction(actionNewFile);
+    m[fileMenu]->addAction(actionOpen);
+    m[fileMenu]->addMenu(closedDocumentsMenu);
+    m[fileMenu]->addSeparator();
+    m[fileMenu]->setMergePoint();
+    m[fileMenu]->addAction(actionClose);
+    m[fileMenu]->addAction(actionCloseAll);
+    m[fileMenu]->addAction(actionCloseOthers);
+    m[fileMenu]->addSeparator();
+    m[fileMenu]->addAction(actionQuit);
+    m[settingsMenu]->addAction(actionConfig);
+    m[settingsMenu]->addAction(showDocksAction);
+    m[settingsMenu]->setMergePoint();
+    m[settingsMenu]->addSeparator();
+    m[settingsMenu]->addAction(actionNextTab);
+    m[settingsMenu]->addAction(actionPrevTab);
+    m[settingsMenu]->addAction(actionHideGUI);
+    m[settingsMenu]->addAction(actionMoveTabLeft);
+    m[settingsMenu]->addAction(actionMoveTabRight);
 
     toolbars[tr("main")]->addAction(actionNewFile);
     toolbars[tr("main")]->addAction(actionOpen);
@@ -1183,6 +1186,7 @@ void PluginManager::initGUI() {
 
     mdiServer->setOnMdiSelected([this](qmdiClient *, int) { updateActionsStatus(); });
     addBuiltinActions();
+    setDeferredUpdates(true);
     updateGUI();
 }
 
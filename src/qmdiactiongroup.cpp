@@ -6,14 +6,19 @@
  * \see qmdiActionGroup
  */
 
+#include <limits>
+
 #include <QAction>
 #include <QActionGroup>
 #include <QApplication>
 #include <QIcon>
 #include <QMainWindow>
 #include <QMenu>
+#include <QPointer>
+#include <QSet>
 #include <QStyle>
 #include <QToolBar>
+#include <QWidgetAction>
 
 #include "qmdiactiongroup.h"
 
@@ -59,6 +64,14 @@
  * \see qmdiActionGroupList::updateToolBar()
  */
 
+/**
+ * \var qmdiActionGroup::nameAtom
+ * \brief the atom of the name of the group
+ *
+ * \internal
+ * \see internName()
+ */
+
 /**
  * \var qmdiActionGroup::actionGroupItems
  * \brief sub items in this list
@@ -66,7 +79,7 @@
  * A list of \b QAction or \b QWidget which shuold be displayed on the toolbars
  * or menus created by this list. Items can be put into this list by addding
  * them directly (using addAction() or addWidget() ) or by merging in another
- * action group.
+ * action group. Separators are stored as plain QObject items (see separators).
  *
  * \internal
  * \see mergeGroup()
@@ -74,6 +87,23 @@
  * \see addWidget()
  */
 
+/**
+ * \var qmdiActionGroup::actionGroupItemsIndex
+ * \brief position of each item inside actionGroupItems
+ *
+ * A side index which maps every item found in actionGroupItems to its
+ * position in that list. It is used to answer membership queries and to
+ * locate items to be removed without scanning the whole list, which makes
+ * merging big groups much cheaper.
+ *
+ * This index must be kept in sync with actionGroupItems - never modify the
+ * list directly, use insertItem() and removeItemAt() instead.
+ *
+ * \internal
+ * \see insertItem()
+ * \see removeItemAt()
+ */
+
 /**
  * \var qmdiActionGroup::actionGroups
  * \brief other groups available in this group
@@ -84,6 +114,26 @@
  * \see mergeGroup()
  */
 
+/**
+ * \var qmdiActionGroup::separators
+ * \brief separators created by this group
+ *
+ * A separator is stored in actionGroupItems as a plain QObject, which only
+ * gives the separator an identity (so it can be merged, indexed and
+ * un-merged like any other item). The QAction displaying it is taken from a
+ * shared pool when a menu or toolbar is rendered. The group which created
+ * the separator owns it, and deletes it on destruction.
+ *
+ * Separators of merged groups are not shared: this group creates its own
+ * separator for each of them when merging, and deletes it when un-merging.
+ * This way, rendering this group never touches the items owned by a merged
+ * group which has been destroyed.
+ *
+ * \internal
+ * \see addSeparator()
+ * \see separatorAction()
+ */
+
 /**
  * \var qmdiActionGroup::breakCount
  * \brief
@@ -102,6 +152,146 @@
  * \see mergeGroup()
  */
 
+/**
+ * \var qmdiActionGroup::effectiveMergeLocation
+ * \brief the location in which merged groups are placed
+ *
+ * This is the merge point computed from this group and all the merged
+ * in groups (see getMergePoint()). It is cached, and updated when groups
+ * are merged or un-merged, or when a new merge point is set.
+ *
+ * \internal
+ * \see updateMergePoint()
+ */
+
+/**
+ * \var qmdiActionGroup::mergePriority
+ * \brief the priority of this group, when merged into another group
+ *
+ * \internal
+ * \see setMergePriority()
+ */
+
+/**
+ * \var qmdiActionGroup::mergeSequence
+ * \brief counter of merges done into this group
+ *
+ * Used to order merged groups of the same priority by the time they
+ * have been merged.
+ *
+ * \internal
+ * \see mergedRuns
+ */
+
+/**
+ * \var qmdiActionGroup::mergedRuns
+ * \brief the items each merged group contributed to this group
+ *
+ * Every merged group contributes a contiguous run of items, placed at the
+ * merge point. The runs are kept sorted by (priority, merge sequence), and
+ * their order in this map is the order in which they are displayed.
+ *
+ * \internal
+ * \see mergeGroup()
+ * \see mergedRunKeys
+ */
+
+/**
+ * \var qmdiActionGroup::mergedRunKeys
+ * \brief the key in mergedRuns of each merged group
+ *
+ * \internal
+ * \see mergedRuns
+ */
+
+/**
+ * \var qmdiActionGroup::actionNames
+ * \brief index of the actions in this group by their object name
+ *
+ * Used by findActionNamed(). The index is built from actionGroupItems, which
+ * also contains the items of all merged groups (and the groups merged into
+ * them), so a single lookup covers the whole merge chain.
+ *
+ * \internal
+ * \see updateActionNames()
+ */
+
+/**
+ * \var qmdiActionGroup::actionNamesGeneration
+ * \brief the generation of this group when actionNames was built
+ *
+ * When different from generation, the index is stale and will be rebuilt
+ * on the next lookup. It is reset to 0 when an indexed action is renamed.
+ *
+ * \internal
+ * \see updateActionNames()
+ */
+
+/**
+ * \var qmdiActionGroup::actionNamesConnections
+ * \brief connections to QObject::objectNameChanged() of the indexed actions
+ *
+ * \internal
+ * \see updateActionNames()
+ */
+
+/**
+ * \var qmdiActionGroup::overlay
+ * \brief a group displayed on top of the items of this group
+ *
+ * \internal
+ * \see setOverlay()
+ */
+
+/**
+ * \var qmdiActionGroup::overlayItems
+ * \brief the items to display for each overlay which has been set
+ *
+ * For each overlay, the items of this group with the items of the overlay
+ * placed at the merge point, and the widgets the overlay adds to them. Each
+ * entry remembers the generations it has been computed from, and is
+ * re-computed only if this group or the overlay have been modified since.
+ *
+ * \internal
+ * \see displayedItems()
+ */
+
+/**
+ * \var qmdiActionGroup::itemsGeneration
+ * \brief stamp of the last modification of the items of this group
+ *
+ * Unlike generation, this stamp does not change when the overlay changes.
+ *
+ * \internal
+ * \see overlayItems
+ */
+
+/**
+ * \var qmdiActionGroup::generation
+ * \brief stamp of the last modification of this group
+ *
+ * Every modification of the items of this group (or its name) assigns
+ * a new value to this variable. The values are taken from a process wide
+ * counter, so two different groups never share a generation.
+ *
+ * Widgets rendered from this group remember the generation they display,
+ * which lets updateToolBar() skip toolbars which are already up to date.
+ *
+ * \internal
+ * \see touch()
+ */
+
+/**
+ * \var qmdiActionGroup::nameGeneration
+ * \brief stamp of the last time any group has been renamed
+ *
+ * Lets qmdiActionGroupList know that its index of groups by name is stale.
+ *
+ * \internal
+ * \see setName()
+ */
+quint64 qmdiActionGroup::nameGeneration = 0;
+
 /**
  * \brief Constructs an MDI action group
  * \param name the name of the action group
@@ -124,10 +314,17 @@
  */
 qmdiActionGroup::qmdiActionGroup(const QString &name) {
     this->name = name;
+    nameAtom = internName(name);
 
     breakAfter = false;
     breakCount = -1;
     mergeLocation = -1;
+    effectiveMergeLocation = -1;
+    mergePriority = 0;
+    mergeSequence = 0;
+    actionNamesGeneration = 0;
+    overlay = nullptr;
+    touch();
 }
 
 qmdiActionGroup::qmdiActionGroup() : qmdiActionGroup(QString()) {}
@@ -136,8 +333,13 @@ qmdiActionGroup::qmdiActionGroup() : qmdiActionGroup(QString()) {}
  * Empty destructor. Destroys the object.
  */
 qmdiActionGroup::~qmdiActionGroup() {
+    for (auto const &c : std::as_const(actionNamesConnections)) {
+        QObject::disconnect(c);
+    }
     actionGroupItems.clear();
+    actionGroupItemsIndex.clear();
     actionGroups.clear();
+    qDeleteAll(separators);
 }
 
 /**
@@ -171,7 +373,12 @@ qmdiActionGroup::~qmdiActionGroup() {
  * \see updateMenu()
  * \see updateToolBar()
  */
-void qmdiActionGroup::setName(const QString &newName) { this->name = newName; }
+void qmdiActionGroup::setName(const QString &newName) {
+    this->name = newName;
+    nameAtom = internName(newName);
+    touch();
+    nameGeneration = generation;
+}
 
 /**
  * \brief returns the name of the action group
@@ -183,6 +390,56 @@ void qmdiActionGroup::setName(const QString &newName) { this->name = newName; }
  */
 QString qmdiActionGroup::getName() const { return name; }
 
+/**
+ * \fn qmdiActionGroup::getNameAtom()
+ * \brief returns the atom of the name of this group
+ * \return a number which identifies the name of this group
+ * \since 0.1.1
+ *
+ * Groups with the same name have the same atom, in all lists.
+ *
+ * \see internName()
+ */
+
+/**
+ * \brief returns the atom of a group name
+ * \param name a group name
+ * \return a number which identifies the name
+ * \since 0.1.1
+ *
+ * Names are interned in a process wide table, so each distinct name is
+ * hashed once, and afterwards groups are matched by comparing integers.
+ * Atoms are never re-used. This should be called only from the GUI thread.
+ *
+ * \see getNameAtom()
+ */
+int qmdiActionGroup::internName(const QString &name) {
+    static QHash<QString, int> atoms;
+    auto it = atoms.constFind(name);
+    if (it != atoms.constEnd()) {
+        return *it;
+    }
+    return atoms.insert(name, int(atoms.size()) + 1).value();
+}
+
+/**
+ * \fn qmdiActionGroup::getGeneration()
+ * \brief returns the modification stamp of this group
+ * \return the generation of this group
+ * \since 0.1.1
+ *
+ * The generation changes every time this group is modified: items added,
+ * removed, other groups merged or un-merged, or the name has been changed.
+ * Generations are unique across all groups, so comparing the generation
+ * which has been rendered into a widget with the current one tells if the
+ * widget is up to date.
+ *
+ * When an overlay is set (see setOverlay()), the generation also changes
+ * when the overlay is modified.
+ *
+ * \see qmdiActionGroupList::getGeneration()
+ */
+
 /**
  * \brief add a new action to the action group
  * \param action item to be added to the action group
@@ -209,11 +466,7 @@ void qmdiActionGroup::addAction(QAction *action, int location) {
         removeAction(action);
     }
 
-    if (location != -1) {
-        actionGroupItems.insert(location, action);
-    } else {
-        actionGroupItems << action;
-    }
+    insertItem(action, location);
 }
 
 /**
@@ -256,11 +509,8 @@ void qmdiActionGroup::addActions(QActionGroup *actions, int location) {
  * \see setMergePoint
  */
 void qmdiActionGroup::addWidget(QWidget *widget, int location) {
-    if (location != -1) {
-        actionGroupItems.insert(location, widget);
-    } else {
-        actionGroupItems << widget;
-    }
+    removeWidget(widget);
+    insertItem(widget, location);
 }
 
 /**
@@ -283,11 +533,8 @@ void qmdiActionGroup::addWidget(QWidget *widget, int location) {
  * \see setMergePoint
  */
 void qmdiActionGroup::addMenu(QMenu *menu, int location) {
-    if (location != -1) {
-        actionGroupItems.insert(location, menu);
-    } else {
-        actionGroupItems << menu;
-    }
+    removeMenu(menu);
+    insertItem(menu, location);
 }
 
 /**
@@ -299,14 +546,19 @@ void qmdiActionGroup::addMenu(QMenu *menu, int location) {
  * separator will be added to the end of the list,
  * unless a location is not -1.
  *
+ * No QAction is allocated for the separator. Menus and toolbars display
+ * separators using actions from a shared pool, which are created only when
+ * needed, and are reused by all menus and toolbars. The pool is owned by
+ * the application object.
+ *
  * \see addAction
  * \see removeAction
  * \see setMergePoint
  */
 void qmdiActionGroup::addSeparator(int location) {
-    auto separator = new QAction();
-    separator->setSeparator(true);
-    addAction(separator, location);
+    auto separator = new QObject();
+    separators << separator;
+    insertItem(separator, location);
 }
 
 /**
@@ -318,7 +570,7 @@ void qmdiActionGroup::addSeparator(int location) {
  * the action group.
  */
 bool qmdiActionGroup::containsAction(const QAction *action) const {
-    return actionGroupItems.contains(action);
+    return actionGroupItemsIndex.contains(action);
 }
 
 /**
@@ -331,9 +583,9 @@ bool qmdiActionGroup::containsAction(const QAction *action) const {
  * \see addAction
  */
 void qmdiActionGroup::removeAction(const QAction *action) {
-    auto i = actionGroupItems.indexOf(action);
+    auto i = actionGroupItemsIndex.value(action, -1);
     if (i != -1) {
-        actionGroupItems.removeAt(i);
+        removeItemAt(i);
     }
 }
 
@@ -368,9 +620,9 @@ void qmdiActionGroup::removeActions(QActionGroup *actions) {
  * \see updateMenu
  */
 void qmdiActionGroup::removeMenu(const QMenu *menu) {
-    auto i = actionGroupItems.indexOf(menu);
+    auto i = actionGroupItemsIndex.value(menu, -1);
     if (i != -1) {
-        actionGroupItems.removeAt(i);
+        removeItemAt(i);
     }
 }
 
@@ -388,9 +640,9 @@ void qmdiActionGroup::removeMenu(const QMenu *menu) {
  * \see updateToolBar
  */
 void qmdiActionGroup::removeWidget(const QWidget *widget) {
-    auto i = actionGroupItems.indexOf(widget);
+    auto i = actionGroupItemsIndex.value(widget, -1);
     if (i != -1) {
-        actionGroupItems.removeAt(i);
+        removeItemAt(i);
     }
 }
 
@@ -403,7 +655,10 @@ void qmdiActionGroup::removeWidget(const QWidget *widget) {
  * location to merge new action groups.
  *
  */
-void qmdiActionGroup::setMergePoint() { mergeLocation = actionGroupItems.count(); }
+void qmdiActionGroup::setMergePoint() {
+    mergeLocation = actionGroupItems.count();
+    updateMergePoint();
+}
 
 /**
  * \brief compute the best merging point for new action groups
@@ -417,24 +672,39 @@ void qmdiActionGroup::setMergePoint() { mergeLocation = actionGroupItems.count()
  * If no merging point is defined, the default is to merge at the top
  * of menu or toolbar.
  *
- * \todo action groups should also have merging priorities
+ * The value is cached, so calling this function is cheap.
+ *
  * \see mergeGroup
+ * \see setMergePriority
  */
-int qmdiActionGroup::getMergePoint() const {
-    auto i = -1;
-
-    for (auto const actionGroup : actionGroups) {
-        if (actionGroup->mergeLocation > i) {
-            i = actionGroup->mergeLocation;
-        }
-    }
+int qmdiActionGroup::getMergePoint() const { return effectiveMergeLocation; }
 
-    if (mergeLocation > i) {
-        i = mergeLocation;
-    }
+/**
+ * \fn qmdiActionGroup::setMergePriority(int)
+ * \brief set the priority used when this group is merged into another one
+ * \param priority the new priority, default is 0
+ * \since 0.1.1
+ *
+ * When several groups are merged into the same group, their items are
+ * ordered by priority: groups with a lower priority are displayed first.
+ * Groups with the same priority are displayed in the order they have been
+ * merged. This makes the final order independent of the order in which
+ * plugins (for example) are loaded.
+ *
+ * The priority is read when the group is merged, changing it does not
+ * affect groups into which this group is already merged.
+ *
+ * \see getMergePriority()
+ * \see mergeGroup()
+ */
 
-    return i;
-}
+/**
+ * \fn qmdiActionGroup::getMergePriority()
+ * \brief returns the priority used when this group is merged into another one
+ * \since 0.1.1
+ *
+ * \see setMergePriority()
+ */
 
 /**
  * \brief finds an action
@@ -445,23 +715,17 @@ int qmdiActionGroup::getMergePoint() const {
  * an assumption that the action has been set an object name (`QObject::setObjectName()`). It will
  * look for the action in all nested action groups.
  *
- * If not found, then it will look in local group items.
+ * If several actions share the same name, the first one displayed is returned.
+ *
+ * Lookups use a hash which is built on demand, and re-built only after the
+ * group has been modified or one of its actions has been renamed. Repeated
+ * lookups cost O(1).
  */
-QAction *qmdiActionGroup::findActionNamed(const QString &name) {
-    for (auto &actionGroup : actionGroups) {
-        auto action = actionGroup->findActionNamed(name);
-        if (action) {
-            return action;
-        }
+QAction *qmdiActionGroup::findActionNamed(const QString &name) const {
+    if (actionNamesGeneration != getGeneration()) {
+        updateActionNames();
     }
-    for (auto &groupItem : actionGroupItems) {
-        if (groupItem->objectName() == name) {
-            if (auto action = qobject_cast<QAction *>(groupItem)) {
-                return action;
-            }
-        }
-    }
-    return {};
+    return actionNames.value(name);
 }
 
 /**
@@ -477,106 +741,610 @@ QAction *qmdiActionGroup::findActionNamed(const QString &name) {
  * or the self defined action group. For more documentation see the
  * documentation of getMergePoint.
  *
+ * When several groups are merged, their items are ordered by the priority
+ * of each group, and then by the order in which they were merged. Finding
+ * the location of the new items costs O(log G), where G is the number of
+ * merged groups.
+ *
  * \see unmergeGroup
+ * \see mergeGroups
  * \see setMergePoint
  * \see getMergePoint
+ * \see setMergePriority
  */
 void qmdiActionGroup::mergeGroup(qmdiActionGroup *group) {
     if (!group) {
         return;
     }
+    mergeGroups({group});
+}
 
-    if ((group->breakAfter)) {
-        breakCount = breakCount == -1 ? 1 : breakCount + 1;
+/**
+ * \brief un-merges another action group actions into this action group
+ * \param group the group to be removed from this group
+ *
+ * Use this call if you want to un-merge the items of another group into
+ * one.
+ *
+ * Only the items which the group added when it was merged are removed. Items
+ * which were already available in this group before the merge are kept.
+ *
+ * \see mergeGroup
+ * \see unmergeGroups
+ */
+void qmdiActionGroup::unmergeGroup(const qmdiActionGroup *group) {
+    if (!group) {
+        return;
     }
+    unmergeGroups({group});
+}
 
-    auto i = 0;
-    for (auto &o : group->actionGroupItems) {
-        if (actionGroupItems.contains(o)) {
+/**
+ * \brief merges several action groups into this action group
+ * \param groups the groups to be merged
+ * \since 0.1.1
+ *
+ * This is equivalent to calling mergeGroup() for each group in the list,
+ * but the items of all groups are inserted into this group in a single pass.
+ * Use this when merging many groups at once (for example, when loading
+ * plugins at startup).
+ *
+ * A group which moves the merge point (see setMergePoint()) changes where
+ * the groups merged after it are placed, so the groups which follow it are
+ * merged in another pass.
+ *
+ * \see mergeGroup
+ * \see unmergeGroups
+ */
+void qmdiActionGroup::mergeGroups(const QList<qmdiActionGroup *> &groups) {
+    for (qsizetype i = 0; i + 1 < groups.size(); i++) {
+        auto const group = groups.at(i);
+        if (group && group->mergeLocation > effectiveMergeLocation) {
+            mergeGroups(groups.mid(0, i + 1));
+            mergeGroups(groups.mid(i + 1));
+            return;
+        }
+    }
+
+    // merging a group again moves it to the end of its priority
+    auto merged = QList<const qmdiActionGroup *>();
+    for (auto const group : groups) {
+        if (group && mergedRunKeys.contains(group)) {
+            merged << group;
+        }
+    }
+    unmergeGroups(merged);
+
+    auto added = QSet<const QObject *>();
+    auto keys = QList<MergeKey>();
+    keys.reserve(groups.size());
+    for (auto const group : groups) {
+        if (!group || mergedRunKeys.contains(group)) {
             continue;
         }
-        auto a = qobject_cast<QAction *>(o);
-        if (a) {
-            int m = getMergePoint();
 
-            if (m != -1) {
-                addAction(a, m + i);
-            } else {
-                addAction(a);
+        if ((group->breakAfter)) {
+            breakCount = breakCount == -1 ? 1 : breakCount + 1;
+        }
+
+        auto items = QList<QObject *>();
+        items.reserve(group->actionGroupItems.size());
+        for (auto &o : group->actionGroupItems) {
+            if (actionGroupItemsIndex.contains(o) || added.contains(o)) {
+                continue;
             }
-        } else {
-            auto w = qobject_cast<QWidget *>(o);
-            if (w) {
-                auto m = getMergePoint();
+            if (isSeparator(o)) {
+                auto separator = new QObject();
+                separators.insert(separator);
+                items << separator;
+            } else if (qobject_cast<QAction *>(o)) {
+                items << o;
+            } else {
+                auto w = qobject_cast<QWidget *>(o);
+                if (w) {
+                    items << w;
 
-                if (m != -1) {
-                    addWidget(w, m + i);
+                    // don't display menus, as they are displayed on demand
+                    // when selected in the QMainMenu
+                    if (!w->inherits("QMenu")) {
+                        w->setVisible(true);
+                    }
                 } else {
-                    addWidget(w);
+                    qDebug("%s %d : erorr - wrong QObject type added to action group", __FILE__,
+                           __LINE__);
+                    continue;
                 }
-
-                // don't display menus, as they are displayed on demand
-                // when selected in the QMainMenu
-                if (!w->inherits("QMenu")) {
-                    w->setVisible(true);
-                }
-            } else {
-                qDebug("%s %d : erorr - wrong QObject type added to action group", __FILE__,
-                       __LINE__);
             }
+            added.insert(o);
         }
 
-        i++;
+        auto key = MergeKey(group->mergePriority, ++mergeSequence);
+        mergedRuns.insert(key, {group, items});
+        mergedRunKeys.insert(group, key);
+        keys << key;
+        actionGroups << group;
     }
 
+    // locations are computed against the items already in this group, the new
+    // runs are placed in (priority, sequence) order
+    std::sort(keys.begin(), keys.end());
+    auto runs = QList<QPair<qsizetype, QList<QObject *>>>();
+    runs.reserve(keys.size());
+    for (auto const &key : std::as_const(keys)) {
+        auto location = mergedRunLocation(key);
+        if (location == -1) {
+            location = actionGroupItems.size();
+        }
+        runs << qMakePair(location, mergedRuns.value(key).items);
+    }
+    std::stable_sort(runs.begin(), runs.end(),
+                     [](const auto &a, const auto &b) { return a.first < b.first; });
+    insertRuns(runs);
+
     if (breakCount > 0) {
         breakAfter = true;
     }
 
-    actionGroups << group;
+    for (auto const group : groups) {
+        if (group && group->mergeLocation > effectiveMergeLocation) {
+            effectiveMergeLocation = group->mergeLocation;
+        }
+    }
 }
 
 /**
- * \brief un-merges another action group actions into this action group
- * \param group the group to be removed from this group
+ * \brief un-merges several action groups from this action group
+ * \param groups the groups to be removed from this group
+ * \since 0.1.1
  *
- * Use this call if you want to un-merge the items of another group into
- * one.
+ * This is equivalent to calling unmergeGroup() for each group in the list,
+ * but all the items are removed from this group in a single pass.
  *
- * \see mergeGroup
+ * \see unmergeGroup
+ * \see mergeGroups
  */
-void qmdiActionGroup::unmergeGroup(const qmdiActionGroup *group) {
-    if (!group) {
+void qmdiActionGroup::unmergeGroups(const QList<const qmdiActionGroup *> &groups) {
+    auto items = QList<QObject *>();
+    auto mergedSeparators = QList<QObject *>();
+    for (auto const group : groups) {
+        if (!group) {
+            continue;
+        }
+
+        if ((group->breakAfter)) {
+            breakCount = breakCount > 1 ? -1 : breakCount - 1;
+        }
+
+        // only the items this group contributed are removed, if known
+        auto groupItems = group->actionGroupItems;
+        auto merged = mergedRunKeys.contains(group);
+        if (merged) {
+            groupItems = mergedRuns.take(mergedRunKeys.take(group)).items;
+        }
+
+        for (auto const o : std::as_const(groupItems)) {
+            // the separators of a merged run are copies owned by this group
+            if (merged && isSeparator(o)) {
+                mergedSeparators << o;
+            }
+            if (!actionGroupItemsIndex.contains(o)) {
+                continue;
+            }
+
+            if (qobject_cast<QAction *>(o) || isSeparator(o)) {
+                items << o;
+            } else {
+                auto w = qobject_cast<QWidget *>(o);
+                if (w) {
+                    w->setVisible(false);
+                    items << w;
+                }
+            }
+        }
+    }
+    removeItems(items);
+    for (auto const separator : std::as_const(mergedSeparators)) {
+        separators.remove(separator);
+        delete separator;
+    }
+
+    if (breakCount > 0) {
+        breakAfter = true;
+    }
+
+    auto mergePointRemoved = false;
+    for (auto const group : groups) {
+        auto i = actionGroups.indexOf(group);
+        if (i == -1) {
+            continue;
+        }
+        actionGroups.removeAt(i);
+        if (group->mergeLocation != -1 && group->mergeLocation == effectiveMergeLocation) {
+            mergePointRemoved = true;
+        }
+    }
+    if (mergePointRemoved) {
+        updateMergePoint();
+    }
+}
+
+/**
+ * \brief displays another group on top of this group
+ * \param group the group to display, or nullptr to remove the overlay
+ * \since 0.1.1
+ *
+ * The overlay is displayed as if it has been merged into this group (see
+ * mergeGroup()), but this group is not modified. Menus and toolbars
+ * rendered from this group, and findActionNamed(), see the items of the
+ * overlay. Other methods (containsAction() for example) only look at the
+ * items of this group.
+ *
+ * The first time an overlay is set, the list of items to display is computed
+ * and kept, so switching between overlays which have already been displayed
+ * costs O(1), regardless of the number of actions in the overlay. This is
+ * what qmdiHost::activateClient() uses when switching tabs. As with
+ * mergeGroup() and unmergeGroup(), the widgets of the overlay are shown when
+ * it is set, and hidden when it is replaced.
+ *
+ * The overlay must outlive this group, or be removed with dropOverlay().
+ *
+ * \see getOverlay()
+ * \see dropOverlay()
+ * \see qmdiActionGroupList::setOverlay()
+ */
+void qmdiActionGroup::setOverlay(const qmdiActionGroup *group) {
+    if (overlay == group) {
         return;
     }
+    if (overlay) {
+        setOverlayWidgetsVisible(false);
+    }
+    overlay = group;
+    generation = nextGeneration();
+    if (overlay) {
+        setOverlayWidgetsVisible(true);
+    }
+}
+
+/**
+ * \fn qmdiActionGroup::getOverlay()
+ * \brief returns the group displayed on top of this group
+ * \return the overlay, or nullptr if no overlay has been set
+ * \since 0.1.1
+ *
+ * \see setOverlay()
+ */
+
+/**
+ * \fn qmdiActionGroup::getOverlayCacheSize()
+ * \brief returns the number of overlays whose items are kept by this group
+ * \since 0.1.1
+ *
+ * Every group set with setOverlay() is kept until it is released with
+ * dropOverlay().
+ *
+ * \see dropOverlay()
+ */
+
+/**
+ * \brief forget the items computed for an overlay
+ * \param group the overlay
+ * \since 0.1.1
+ *
+ * Call this when \b group is about to be destroyed. If it is the current
+ * overlay, the overlay is removed.
+ *
+ * \see setOverlay()
+ */
+void qmdiActionGroup::dropOverlay(const qmdiActionGroup *group) {
+    if (overlay == group) {
+        setOverlay(nullptr);
+    }
+    overlayItems.remove(group);
+}
+
+/**
+ * \brief returns the items which menus and toolbars should display
+ * \return the items of this group, including the items of the overlay
+ *
+ * Without an overlay, these are the items of this group. Otherwise, the items
+ * of the overlay are placed where mergeGroup() would have placed them. The
+ * list is cached per overlay.
+ *
+ * \internal
+ * \see overlayItems
+ */
+const QList<QObject *> &qmdiActionGroup::displayedItems() const {
+    if (!overlay) {
+        return actionGroupItems;
+    }
+
+    auto &cached = overlayItems[overlay];
+    if (cached.itemsGeneration == itemsGeneration &&
+        cached.overlayGeneration == overlay->getGeneration()) {
+        return cached.items;
+    }
 
-    if ((group->breakAfter)) {
-        breakCount = breakCount > 1 ? -1 : breakCount - 1;
+    auto key = MergeKey(overlay->mergePriority, std::numeric_limits<quint64>::max());
+    auto location = mergedRunLocation(key);
+    if (location == -1) {
+        location = actionGroupItems.size();
     }
 
-    for (auto const o : group->actionGroupItems) {
-        if (!actionGroupItems.contains(o)) {
+    auto const &items = overlay->displayedItems();
+    cached.items.clear();
+    cached.widgets.clear();
+    cached.items.reserve(actionGroupItems.size() + items.size());
+    cached.items.append(actionGroupItems.mid(0, location));
+    for (auto const o : items) {
+        if (actionGroupItemsIndex.contains(o)) {
             continue;
         }
+        cached.items << o;
 
-        auto a = qobject_cast<QAction *>(o);
-        if (a) {
-            removeAction(a);
-        } else {
-            auto w = qobject_cast<QWidget *>(o);
-            if (w) {
-                w->setVisible(false);
-                removeWidget(w);
+        // menus are displayed on demand, see mergeGroups()
+        auto w = qobject_cast<QWidget *>(o);
+        if (w && !w->inherits("QMenu")) {
+            cached.widgets << w;
+        }
+    }
+    cached.items.append(actionGroupItems.mid(location));
+    cached.itemsGeneration = itemsGeneration;
+    cached.overlayGeneration = overlay->getGeneration();
+    return cached.items;
+}
+
+/**
+ * \brief shows or hides the widgets added by the overlay
+ * \param visible true to show the widgets
+ *
+ * \internal
+ * \see setOverlay()
+ */
+void qmdiActionGroup::setOverlayWidgetsVisible(bool visible) const {
+    displayedItems();
+    for (auto const w : std::as_const(overlayItems[overlay].widgets)) {
+        w->setVisible(visible);
+    }
+}
+
+/**
+ * \brief find where the items of a merged group should be inserted
+ * \param key the (priority, sequence) of the merged group
+ * \return the location in actionGroupItems, or -1 to append
+ *
+ * The items are placed just before the items of the next merged group in
+ * (priority, sequence) order. If this is the last merged group, they are
+ * placed after the items of the previous one. The first merged group is
+ * placed at the merge point. The group does not need to be in mergedRuns.
+ *
+ * \internal
+ * \see mergedRuns
+ */
+qsizetype qmdiActionGroup::mergedRunLocation(const MergeKey &key) const {
+    for (auto next = mergedRuns.upperBound(key); next != mergedRuns.cend(); ++next) {
+        for (auto const o : next->items) {
+            auto i = actionGroupItemsIndex.value(o, -1);
+            if (i != -1) {
+                return i;
             }
         }
     }
 
-    if (breakCount > 0) {
-        breakAfter = true;
+    auto mergePoint = getMergePoint();
+    if (mergePoint == -1) {
+        return -1;
+    }
+    for (auto run = mergedRuns.lowerBound(key); run != mergedRuns.cbegin();) {
+        --run;
+        for (auto o = run->items.crbegin(); o != run->items.crend(); ++o) {
+            auto i = actionGroupItemsIndex.value(*o, -1);
+            if (i != -1) {
+                return i + 1;
+            }
+        }
+    }
+    return mergePoint;
+}
+
+/**
+ * \brief re-build the index of actions by name
+ *
+ * Every indexed action is watched for QObject::objectNameChanged(), which
+ * invalidates the index.
+ *
+ * \internal
+ * \see actionNames
+ * \see findActionNamed()
+ */
+void qmdiActionGroup::updateActionNames() const {
+    for (auto const &c : std::as_const(actionNamesConnections)) {
+        QObject::disconnect(c);
+    }
+    actionNamesConnections.clear();
+    actionNames.clear();
+
+    for (auto const o : displayedItems()) {
+        auto a = qobject_cast<QAction *>(o);
+        if (!a) {
+            continue;
+        }
+        if (!a->objectName().isEmpty() && !actionNames.contains(a->objectName())) {
+            actionNames.insert(a->objectName(), a);
+        }
+        actionNamesConnections << QObject::connect(a, &QObject::objectNameChanged,
+                                                   [this]() { actionNamesGeneration = 0; });
     }
+    actionNamesGeneration = getGeneration();
+}
+
+/**
+ * \brief re-compute the cached merge point
+ *
+ * Walks over all merged groups, and finds the best merge point. This is
+ * needed only when the group which defined the current merge point is gone,
+ * or the merge point of this group has been modified.
+ *
+ * \internal
+ * \see getMergePoint()
+ * \see effectiveMergeLocation
+ */
+void qmdiActionGroup::updateMergePoint() {
+    effectiveMergeLocation = mergeLocation;
+    for (auto const actionGroup : std::as_const(actionGroups)) {
+        if (actionGroup->mergeLocation > effectiveMergeLocation) {
+            effectiveMergeLocation = actionGroup->mergeLocation;
+        }
+    }
+}
+
+/**
+ * \brief mark this group as modified
+ *
+ * Assigns a new generation to this group, so the widgets displaying it will be
+ * updated the next time they are rendered.
+ *
+ * \internal
+ * \see generation
+ */
+void qmdiActionGroup::touch() {
+    generation = nextGeneration();
+    itemsGeneration = generation;
+}
+
+/**
+ * \brief returns a new generation
+ * \return a generation, unique across all groups
+ *
+ * \internal
+ * \see touch()
+ */
+quint64 qmdiActionGroup::nextGeneration() {
+    static quint64 lastGeneration = 0;
+    return ++lastGeneration;
+}
 
-    if (actionGroups.contains(group)) {
-        actionGroups.removeAt(actionGroups.indexOf(group));
+/**
+ * \brief insert an item into the list of items, keeping the index in sync
+ * \param item the QAction or QWidget to insert
+ * \param location where to insert the item, -1 means append
+ *
+ * Appending is O(1). Inserting in the middle of the list needs to update
+ * the index of all the items that follow the new one.
+ *
+ * \internal
+ * \see actionGroupItemsIndex
+ */
+void qmdiActionGroup::insertItem(QObject *item, int location) {
+    touch();
+    if (location < 0 || location >= actionGroupItems.size()) {
+        actionGroupItemsIndex.insert(item, actionGroupItems.size());
+        actionGroupItems << item;
+        return;
+    }
+
+    actionGroupItems.insert(location, item);
+    reindexItems(location);
+}
+
+/**
+ * \brief insert runs of items into the list of items
+ * \param runs pairs of location and items to insert, sorted by location
+ *
+ * Each run is inserted as a contiguous block before the item found at its
+ * location in the current list. The list is rebuilt in a single pass, and the
+ * index is updated once, regardless of the number of runs and items inserted.
+ *
+ * \internal
+ * \see insertItem()
+ */
+void qmdiActionGroup::insertRuns(const QList<QPair<qsizetype, QList<QObject *>>> &runs) {
+    auto count = qsizetype(0);
+    for (auto const &run : runs) {
+        count += run.second.size();
+    }
+    if (count == 0) {
+        return;
+    }
+
+    touch();
+    auto items = QList<QObject *>();
+    items.reserve(actionGroupItems.size() + count);
+    auto from = qsizetype(0);
+    auto first = qsizetype(-1);
+    for (auto const &run : runs) {
+        auto location = qBound(from, run.first, actionGroupItems.size());
+        items.append(actionGroupItems.mid(from, location - from));
+        if (first == -1 && !run.second.isEmpty()) {
+            first = items.size();
+        }
+        items.append(run.second);
+        from = location;
+    }
+    items.append(actionGroupItems.mid(from));
+    actionGroupItems.swap(items);
+    reindexItems(first);
+}
+
+/**
+ * \brief remove a set of items from the list of items
+ * \param items the items to remove, items not in this group are ignored
+ *
+ * The list is compacted in a single pass, and the index is updated once
+ * starting at the first removed item.
+ *
+ * \internal
+ * \see removeItemAt()
+ */
+void qmdiActionGroup::removeItems(const QList<QObject *> &items) {
+    auto first = actionGroupItems.size();
+    for (auto const o : items) {
+        auto i = actionGroupItemsIndex.value(o, -1);
+        if (i != -1) {
+            first = qMin(first, i);
+            actionGroupItemsIndex.remove(o);
+        }
+    }
+    if (first == actionGroupItems.size()) {
+        return;
+    }
+
+    touch();
+    auto j = first;
+    for (auto i = first; i < actionGroupItems.size(); i++) {
+        auto o = actionGroupItems.at(i);
+        if (actionGroupItemsIndex.contains(o)) {
+            actionGroupItems[j++] = o;
+        }
+    }
+    actionGroupItems.resize(j);
+    reindexItems(first);
+}
+
+/**
+ * \brief remove an item from the list of items, keeping the index in sync
+ * \param index the position of the item to be removed
+ *
+ * \internal
+ * \see actionGroupItemsIndex
+ */
+void qmdiActionGroup::removeItemAt(qsizetype index) {
+    touch();
+    actionGroupItemsIndex.remove(actionGroupItems.at(index));
+    actionGroupItems.removeAt(index);
+    reindexItems(index);
+}
+
+/**
+ * \brief update the index of all items starting at some position
+ * \param from the first position which needs to be updated
+ *
+ * \internal
+ * \see actionGroupItemsIndex
+ */
+void qmdiActionGroup::reindexItems(qsizetype from) {
+    for (auto i = from; i < actionGroupItems.size(); i++) {
+        actionGroupItemsIndex[actionGroupItems.at(i)] = i;
     }
 }
 
@@ -598,10 +1366,17 @@ void qmdiActionGroup::unmergeGroup(const qmdiActionGroup *group) {
  * nullptr will be the returned value. If the passed \b menu is not nullptr
  * it will be deallocated.
  *
+ * When an existing menu is passed, it is not cleared. Instead, the actions
+ * it already displays are compared against the items of this group, and only
+ * the missing actions are inserted (and the stale ones removed). The menu
+ * also remembers the generation it displays, and if this group has not been
+ * modified since the last update, the menu is returned untouched.
+ *
  * \see updateToolBar
  */
 QMenu *qmdiActionGroup::updateMenu(QMenu *menu, bool needEmptyIcon) const {
-    if (actionGroupItems.isEmpty()) {
+    auto const &items = displayedItems();
+    if (items.isEmpty()) {
         delete menu;
         return nullptr;
     }
@@ -609,31 +1384,98 @@ QMenu *qmdiActionGroup::updateMenu(QMenu *menu, bool needEmptyIcon) const {
     if (!menu) {
         menu = new QMenu(name);
         if (needEmptyIcon) {
-            auto iconSize =
-                QSize(menu->style()->pixelMetric(QStyle::PM_SmallIconSize, nullptr, menu),
-                      menu->style()->pixelMetric(QStyle::PM_SmallIconSize, nullptr, menu));
-
-            auto emptyPixmap = QPixmap(iconSize);
-            emptyPixmap.fill(Qt::transparent);
-            auto emptyIcon = QIcon(emptyPixmap);
-            menu->setIcon(emptyIcon);
+            menu->setIcon(emptyIcon(menu));
         }
+    } else if (menu->property("qmdiGeneration").toULongLong() == getGeneration()) {
+        return menu;
     } else {
         menu->setTitle(name);
     }
-    menu->clear();
 
-    for (auto &o : actionGroupItems) {
+    auto actions = QList<QAction *>();
+    auto separatorCount = qsizetype(0);
+    actions.reserve(items.size());
+    for (auto &o : items) {
+        if (isSeparator(o)) {
+            actions << separatorAction(separatorCount++);
+            continue;
+        }
+
         auto a = qobject_cast<QAction *>(o);
         if (a) {
-            menu->addAction(a);
+            actions << a;
         }
 
         auto m = qobject_cast<QMenu *>(o);
         if (m) {
-            menu->addMenu(m);
+            actions << m->menuAction();
         }
     }
+    syncActions(menu, actions);
+    menu->setProperty("qmdiGeneration", getGeneration());
+
+    return menu;
+}
+
+/**
+ * \brief generates a placeholder menu, which is populated when shown
+ * \param menu the placeholder to update, or nullptr to create a new one
+ * \return the updated placeholder menu
+ * \since 0.1.1
+ *
+ * This is the lazy version of updateMenu(). The returned menu has the title
+ * of this group, but it is not populated with the items of the group. The
+ * menu is populated by calling updateMenu() just before it is shown (on
+ * QMenu::aboutToShow()), and as updateMenu() skips menus which already
+ * display the current generation of this group, a menu which is shown
+ * several times is populated only once per modification of this group.
+ *
+ * Shortcuts of actions are only active if the action is reachable from
+ * the window, so the placeholder does contain the actions which have
+ * shortcuts, and the sub menus. Those are usually a small subset of the
+ * group.
+ *
+ * As with updateMenu(), if the group is empty, the menu is deallocated and
+ * nullptr is returned. The menu keeps a reference to this group, so the group
+ * must outlive the returned menu.
+ *
+ * \see qmdiActionGroupList::setLazyMenus()
+ */
+QMenu *qmdiActionGroup::updateLazyMenu(QMenu *menu) const {
+    auto const &items = displayedItems();
+    if (items.isEmpty()) {
+        delete menu;
+        return nullptr;
+    }
+
+    if (!menu) {
+        menu = new QMenu(name);
+    } else if (menu->property("qmdiGeneration").toULongLong() == getGeneration() ||
+               menu->property("qmdiLazyGeneration").toULongLong() == getGeneration()) {
+        return menu;
+    } else {
+        menu->setTitle(name);
+    }
+
+    if (!menu->property("qmdiLazy").toBool()) {
+        QObject::connect(menu, &QMenu::aboutToShow, menu, [this, menu]() { updateMenu(menu); });
+        menu->setProperty("qmdiLazy", true);
+    }
+
+    auto actions = QList<QAction *>();
+    for (auto &o : items) {
+        auto a = qobject_cast<QAction *>(o);
+        if (a && !a->shortcuts().isEmpty()) {
+            actions << a;
+        }
+
+        auto m = qobject_cast<QMenu *>(o);
+        if (m) {
+            actions << m->menuAction();
+        }
+    }
+    syncActions(menu, actions);
+    menu->setProperty("qmdiLazyGeneration", getGeneration());
 
     return menu;
 }
@@ -641,6 +1483,7 @@ QMenu *qmdiActionGroup::updateMenu(QMenu *menu, bool needEmptyIcon) const {
 /**
  * \brief generates an updated toolbar from the items on the group list
  * \param toolbar the toolbar to update
+ * \param withWidgets false to leave the widgets of the group out
  * \return an updated toolbar
  *
  * Call this function to update a QToolBar from these definitions.
@@ -652,44 +1495,205 @@ QMenu *qmdiActionGroup::updateMenu(QMenu *menu, bool needEmptyIcon) const {
  * If you are inserting that QToolBar into a QMainWindow the memory deallocation
  * will be handled by QMainWindow, and you don't have to bother about it.
  *
+ * The toolbar is updated in place: only actions and widgets which have been
+ * added or removed since the last update are inserted or removed. The toolbar
+ * remembers the generation of the group it displays, and if the group has not
+ * been modified since, this function returns immediately. The toolbar is
+ * hidden only when it becomes empty, and shown again when it gets new items.
+ * A toolbar hidden by the user is not modified.
+ *
+ * A QWidget can be displayed by a single toolbar, which takes ownership of
+ * it. When the same group is displayed in several windows, only one of them
+ * should get the widgets, and \b withWidgets should be false for the
+ * others.
+ *
  * \see updateMenu
  */
-QToolBar *qmdiActionGroup::updateToolBar(QToolBar *toolbar) const {
-    if (!toolbar || toolbar->isHidden()) {
+QToolBar *qmdiActionGroup::updateToolBar(QToolBar *toolbar, bool withWidgets) const {
+    if (!toolbar) {
         return toolbar;
     }
 
-    toolbar->setWindowTitle(name);
-    toolbar->setUpdatesEnabled(false);
-    toolbar->hide();
-    toolbar->clear();
-    auto i = 0;
-    for (auto &o : actionGroupItems) {
-        auto a = dynamic_cast<QAction *>(o);
+    auto hiddenByGroup = toolbar->property("qmdiEmptyToolBar").toBool();
+    if (toolbar->isHidden() && toolbar->testAttribute(Qt::WA_WState_ExplicitShowHide) &&
+        !hiddenByGroup) {
+        return toolbar;
+    }
+    if (toolbar->property("qmdiGeneration").toULongLong() == getGeneration()) {
+        return toolbar;
+    }
+
+    if (toolbar->windowTitle() != name) {
+        toolbar->setWindowTitle(name);
+    }
+
+    // widgets are displayed using a QWidgetAction, re-use the ones created
+    // on previous updates
+    auto widgetActions = QHash<const QWidget *, QWidgetAction *>();
+    for (auto wa : toolbar->findChildren<QWidgetAction *>(Qt::FindDirectChildrenOnly)) {
+        if (wa->defaultWidget()) {
+            widgetActions.insert(wa->defaultWidget(), wa);
+        }
+    }
+
+    auto const &items = displayedItems();
+    auto actions = QList<QAction *>();
+    auto separatorCount = qsizetype(0);
+    actions.reserve(items.size());
+    for (auto &o : items) {
+        if (isSeparator(o)) {
+            actions << separatorAction(separatorCount++);
+            continue;
+        }
+        auto a = qobject_cast<QAction *>(o);
         if (a) {
-            toolbar->addAction(a);
-        } else {
-            auto w = dynamic_cast<QWidget *>(o);
-            if (w) {
-                // don't even try to add menus to toolbars, this just does not work
-                if (!w->inherits("QMenu")) {
-                    toolbar->addWidget(w);
-                }
-            }
+            actions << a;
+            continue;
+        }
+        auto w = qobject_cast<QWidget *>(o);
+        // don't even try to add menus to toolbars, this just does not work
+        if (!w || w->inherits("QMenu") || !withWidgets) {
+            continue;
+        }
+        auto wa = widgetActions.value(w);
+        if (!wa) {
+            wa = new QWidgetAction(toolbar);
+            wa->setDefaultWidget(w);
         }
-        i++;
+        actions << wa;
     }
 
-    if (actionGroupItems.count() == 0) {
+    toolbar->setUpdatesEnabled(false);
+    syncActions(toolbar, actions);
+    toolbar->setUpdatesEnabled(true);
+
+    if (actions.isEmpty()) {
         toolbar->hide();
-    } else {
+    } else if (hiddenByGroup) {
         toolbar->show();
     }
-    toolbar->setUpdatesEnabled(true);
+    toolbar->setProperty("qmdiEmptyToolBar", actions.isEmpty());
+    toolbar->setProperty("qmdiGeneration", getGeneration());
 
     return toolbar;
 }
 
+/**
+ * \brief make the actions of a widget match a list of actions
+ * \param widget the widget to be updated (a QMenu or QToolBar)
+ * \param actions the actions which the widget should display, in order
+ *
+ * The list of actions already set on the widget is the record of what has
+ * been rendered into it. This list is compared to the requested one, and only
+ * the minimal set of QWidget::removeAction() and QWidget::insertAction() calls
+ * are made to reach the new state. Actions which are already in place are not
+ * touched at all.
+ *
+ * \internal
+ * \see updateMenu()
+ */
+void qmdiActionGroup::syncActions(QWidget *widget, const QList<QAction *> &actions) {
+    auto current = widget->actions();
+    if (current == actions) {
+        return;
+    }
+
+    auto wanted = QSet<QAction *>(actions.begin(), actions.end());
+    auto kept = QList<QAction *>();
+    kept.reserve(current.size());
+    for (auto a : std::as_const(current)) {
+        if (wanted.contains(a)) {
+            kept << a;
+        } else {
+            widget->removeAction(a);
+        }
+    }
+
+    for (auto i = 0; i < actions.size(); i++) {
+        auto a = actions.at(i);
+        if (i < kept.size() && kept.at(i) == a) {
+            continue;
+        }
+
+        // QWidget::insertAction() moves the action if it is already displayed
+        auto before = i < kept.size() ? kept.at(i) : nullptr;
+        widget->insertAction(before, a);
+        auto old = kept.indexOf(a, i);
+        if (old != -1) {
+            kept.removeAt(old);
+        }
+        kept.insert(i, a);
+    }
+}
+
+/**
+ * \brief returns a transparent icon, sized as the icons of a menu
+ * \param menu the menu which will display the icon
+ * \return an empty icon
+ *
+ * The icon is shared by all the menus with the same style and icon size.
+ *
+ * \internal
+ * \see updateMenu()
+ */
+QIcon qmdiActionGroup::emptyIcon(const QMenu *menu) {
+    static QHash<QPair<const QStyle *, int>, QIcon> icons;
+    auto style = menu->style();
+    auto size = style->pixelMetric(QStyle::PM_SmallIconSize, nullptr, menu);
+    auto key = qMakePair(static_cast<const QStyle *>(style), size);
+    auto it = icons.constFind(key);
+    if (it != icons.constEnd()) {
+        return *it;
+    }
+
+    auto emptyPixmap = QPixmap(QSize(size, size));
+    emptyPixmap.fill(Qt::transparent);
+    return icons.insert(key, QIcon(emptyPixmap)).value();
+}
+
+/**
+ * \brief returns if an item of the group is a separator
+ * \param item an item found in actionGroupItems
+ * \return true if the item represents a separator
+ *
+ * Separators are the only plain QObject instances stored in the group.
+ *
+ * \internal
+ * \see separators
+ */
+bool qmdiActionGroup::isSeparator(const QObject *item) {
+    return item && item->metaObject() == &QObject::staticMetaObject;
+}
+
+/**
+ * \brief returns a separator action from the shared pool
+ * \param index the number of the separator inside the rendered widget
+ * \return a QAction which is a separator
+ *
+ * A QWidget cannot display the same action twice, so each separator inside
+ * a menu or toolbar needs its own action. The n-th separator of every menu
+ * and toolbar uses the same action, so the pool only grows to the maximal
+ * number of separators found in a single widget. Actions are created on
+ * demand, and are owned by the application object. If the application
+ * object is destroyed (and another one is created, as tests do), the
+ * actions are created again.
+ *
+ * \internal
+ * \see separators
+ */
+QAction *qmdiActionGroup::separatorAction(qsizetype index) {
+    static QList<QPointer<QAction>> pool;
+    if (pool.size() <= index) {
+        pool.resize(index + 1);
+    }
+    auto &separator = pool[index];
+    if (!separator) {
+        separator = new QAction(QCoreApplication::instance());
+        separator->setSeparator(true);
+    }
+    return separator;
+}
+
 void qmdiActionGroup::addActionsToWidget(QWidget *widget) {
     for (auto &a : actionGroups) {
         a->addActionsToWidget(widget);
@@ -8,10 +8,16 @@
  * \see qmdiActionGroup
  */
 
+#include <QHash>
 #include <QList>
+#include <QMap>
+#include <QMetaObject>
+#include <QPair>
+#include <QSet>
 
 class QAction;
 class QActionGroup;
+class QIcon;
 class QMenu;
 class QToolBar;
 class QString;
@@ -20,6 +26,8 @@ class QWidget;
 
 class qmdiActionGroup {
     friend class qmdiHost;
+    friend class qmdiActionGroupList;
+    Q_DISABLE_COPY(qmdiActionGroup)
 
   public:
     explicit qmdiActionGroup(const QString &name);
@@ -29,6 +37,11 @@ class qmdiActionGroup {
     void setName(const QString &newName);
     bool empty() const { return actionGroupItems.empty() && actionGroups.empty(); }
     QString getName() const;
+    int getNameAtom() const { return nameAtom; }
+    static int internName(const QString &name);
+    quint64 getGeneration() const {
+        return overlay ? qMax(generation, overlay->getGeneration()) : generation;
+    }
     void addAction(QAction *action, int location = -1);
     void addActions(QActionGroup *actions, int location = -1);
     void addWidget(QWidget *widget, int location = -1);
@@ -41,23 +54,78 @@ class qmdiActionGroup {
     void removeWidget(const QWidget *widget);
     void setMergePoint();
     int getMergePoint() const;
-    QAction *findActionNamed(const QString &);
+    void setMergePriority(int priority) { mergePriority = priority; }
+    int getMergePriority() const { return mergePriority; }
+    QAction *findActionNamed(const QString &) const;
 
     void mergeGroup(qmdiActionGroup *group);
     void unmergeGroup(const qmdiActionGroup *group);
+    void mergeGroups(const QList<qmdiActionGroup *> &groups);
+    void unmergeGroups(const QList<const qmdiActionGroup *> &groups);
+    void setOverlay(const qmdiActionGroup *group);
+    const qmdiActionGroup *getOverlay() const { return overlay; }
+    qsizetype getOverlayCacheSize() const { return overlayItems.size(); }
+    void dropOverlay(const qmdiActionGroup *group);
 
     QMenu *updateMenu(QMenu *menu = nullptr, bool needeEmptyIcon = false) const;
-    QToolBar *updateToolBar(QToolBar *toolbar) const;
+    QMenu *updateLazyMenu(QMenu *menu = nullptr) const;
+    QToolBar *updateToolBar(QToolBar *toolbar, bool withWidgets = true) const;
     void addActionsToWidget(QWidget *widget);
     void removeActionsFromWidget(QWidget *widget);
 
     bool breakAfter;
 
   private:
+    using MergeKey = QPair<int, quint64>;
+    struct MergedRun {
+        const qmdiActionGroup *group = nullptr;
+        QList<QObject *> items;
+    };
+    struct OverlayItems {
+        quint64 itemsGeneration = 0;
+        quint64 overlayGeneration = 0;
+        QList<QObject *> items;
+        QList<QWidget *> widgets;
+    };
+
+    qsizetype mergedRunLocation(const MergeKey &key) const;
+    const QList<QObject *> &displayedItems() const;
+    void setOverlayWidgetsVisible(bool visible) const;
+    static quint64 nextGeneration();
+    void touch();
+    void insertItem(QObject *item, int location);
+    void insertRuns(const QList<QPair<qsizetype, QList<QObject *>>> &runs);
+    void removeItems(const QList<QObject *> &items);
+    void updateMergePoint();
+    void updateActionNames() const;
+    void removeItemAt(qsizetype index);
+    void reindexItems(qsizetype from);
+    static void syncActions(QWidget *widget, const QList<QAction *> &actions);
+    static QIcon emptyIcon(const QMenu *menu);
+    static bool isSeparator(const QObject *item);
+    static QAction *separatorAction(qsizetype index);
+
     QString name;
+    int nameAtom;
     QList<QObject *> actionGroupItems;
+    QHash<const QObject *, qsizetype> actionGroupItemsIndex;
     QList<qmdiActionGroup *> actionGroups;
+    QSet<QObject *> separators;
 
     int breakCount;
     int mergeLocation;
+    int effectiveMergeLocation;
+    int mergePriority;
+    quint64 mergeSequence;
+    QMap<MergeKey, MergedRun> mergedRuns;
+    QHash<const qmdiActionGroup *, MergeKey> mergedRunKeys;
+
+    mutable QHash<QString, QAction *> actionNames;
+    mutable quint64 actionNamesGeneration;
+    mutable QList<QMetaObject::Connection> actionNamesConnections;
+    const qmdiActionGroup *overlay;
+    mutable QHash<const qmdiActionGroup *, OverlayItems> overlayItems;
+    quint64 itemsGeneration;
+    quint64 generation;
+    static quint64 nameGeneration;
 };
@@ -0,0 +1,142 @@
+#pragma once
+
+/**
+ * \file qmdiactiongrouplayout.h
+ * \brief Definition of the action group layout class
+ * \author Diego Iastrubni (diegoiast@gmail.com)
+ * License LGPL 2 or 3
+ * \see qmdiActionGroupLayout
+ */
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+
+#include <QCoreApplication>
+#include <QString>
+
+#include "qmdiactiongrouplist.h"
+
+/**
+ * \class qmdiActionGroupLayout
+ * \brief a compile time declaration of the groups of an action group list
+ * \since 0.1.1
+ *
+ * Menus and toolbars are usually defined by looking up each group by name,
+ * once for every action added:
+ *
+ * \code
+ * menus["&File"]->addAction(actionOpen);
+ * menus["&File"]->addAction(actionSave);
+ * \endcode
+ *
+ * Instead, the groups can be declared once, and then addressed by their
+ * position (slot) in the declaration. The declaration is a constant
+ * expression, so slots are resolved by the compiler:
+ *
+ * \code
+ * static constexpr auto menuLayout = qmdiActionGroupLayout("&File", "&Edit");
+ * enum { FileMenu, EditMenu };
+ *
+ * static constexpr auto editMenu = menuLayout.slot("&Edit");
+ *
+ * auto m = menuLayout.apply(menus);
+ * m[FileMenu]->addAction(actionOpen);
+ * m[FileMenu]->addAction(actionSave);
+ * m[editMenu]->addAction(actionCopy);
+ * \endcode
+ *
+ * apply() makes room for all the groups in the list at once, and looks up
+ * (or creates) each group a single time, in the declared order.
+ *
+ * \see qmdiActionGroupList
+ */
+template <std::size_t N> class qmdiActionGroupLayout {
+  public:
+    using Groups = std::array<qmdiActionGroup *, N>;
+
+    template <typename... Names>
+    constexpr qmdiActionGroupLayout(Names... groupNames) : names{groupNames...} {
+        static_assert(sizeof...(Names) == N, "wrong number of group names");
+    }
+
+    /**
+     * \brief returns the number of groups in this layout
+     */
+    constexpr std::size_t size() const { return N; }
+
+    /**
+     * \brief returns the name of the group in a slot
+     * \param slot the position of the group in this layout
+     */
+    constexpr const char *name(std::size_t slot) const { return names[slot]; }
+
+    /**
+     * \brief returns true if a group is declared in this layout
+     * \param name the name of the group, as declared
+     */
+    constexpr bool contains(const char *name) const {
+        for (std::size_t i = 0; i < N; i++) {
+            if (sameName(names[i], name)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * \brief finds the slot of a group
+     * \param name the name of the group, as declared
+     * \return the slot of the group
+     *
+     * When the result initializes a constexpr variable, the slot is computed
+     * at compile time, and a name which is not declared in this layout is a
+     * compile error. At run time, std::out_of_range is thrown instead, use
+     * contains() to check the name first.
+     */
+    constexpr std::size_t slot(const char *name) const {
+        for (std::size_t i = 0; i < N; i++) {
+            if (sameName(names[i], name)) {
+                return i;
+            }
+        }
+        throw std::out_of_range("group not declared in the layout");
+    }
+
+    /**
+     * \brief creates the groups of this layout in an action group list
+     * \param list the list to populate
+     * \param context if not nullptr, the names are translated in this context
+     * \return the groups, indexed by slot
+     *
+     * Groups which already exist in \b list are re-used, the others are
+     * appended in the declared order. Use QT_TRANSLATE_NOOP() when declaring
+     * names which are to be translated.
+     */
+    Groups apply(qmdiActionGroupList &list, const char *context = nullptr) const {
+        auto groups = Groups();
+        list.reserve(list.size() + N);
+        for (std::size_t i = 0; i < N; i++) {
+            auto groupName = QString::fromUtf8(names[i]);
+            if (context) {
+                groupName = QCoreApplication::translate(context, names[i]);
+            }
+            groups[i] = list.getActionGroup(groupName);
+        }
+        return groups;
+    }
+
+  private:
+    static constexpr bool sameName(const char *a, const char *b) {
+        while (*a && *a == *b) {
+            a++;
+            b++;
+        }
+        return *a == *b;
+    }
+
+    const char *names[N];
+};
+
+template <typename... Names>
+qmdiActionGroupLayout(Names...) -> qmdiActionGroupLayout<sizeof...(Names)>;
@@ -7,8 +7,11 @@
  */
 
 #include <QAction>
+#include <QHash>
 #include <QMainWindow>
 #include <QMenuBar>
+#include <QPointer>
+#include <QSet>
 #include <QString>
 #include <QToolBar>
 
@@ -38,6 +41,76 @@
  * \see mergeGroup()
  */
 
+/**
+ * \var qmdiActionGroupList::actionGroupsByAtom
+ * \brief the groups of this list, by name atom
+ *
+ * Groups are indexed by the atom of their name (see
+ * qmdiActionGroup::internName()), so looking up a group compares integers.
+ * When several groups share a name, the first one in actionGroups is indexed.
+ * Groups can be renamed after they have been added, so the hash is re-built
+ * when any group has been renamed since it was built.
+ *
+ * \internal
+ * \see getActionGroup()
+ * \see reindexGroups()
+ */
+
+/**
+ * \var qmdiActionGroupList::indexedNameGeneration
+ * \brief the rename stamp of groups when actionGroupsByAtom was built
+ *
+ * \internal
+ * \see qmdiActionGroup::nameGeneration
+ */
+
+/**
+ * \var qmdiActionGroupList::groupMenus
+ * \brief the menu displaying each group, for each menubar
+ *
+ * The same list can be displayed in several menubars (for example, one per
+ * window). Entries of menubars which have been destroyed are removed on the
+ * next update.
+ *
+ * \internal
+ * \see updateMenuBar()
+ */
+
+/**
+ * \var qmdiActionGroupList::groupToolBars
+ * \brief the toolbar displaying each group, for each window
+ *
+ * Entries of windows which have been destroyed are removed on the next
+ * update.
+ *
+ * \internal
+ * \see updateToolBar()
+ */
+
+/**
+ * \var qmdiActionGroupList::overlay
+ * \brief the list displayed on top of this list
+ *
+ * \internal
+ * \see setOverlay()
+ */
+
+/**
+ * \var qmdiActionGroupList::overlaidGroups
+ * \brief the groups of this list which currently display an overlay
+ *
+ * \internal
+ * \see setOverlay()
+ */
+
+/**
+ * \var qmdiActionGroupList::lazyMenus
+ * \brief populate the menus of the menubar only when they are shown
+ *
+ * \internal
+ * \see setLazyMenus()
+ */
+
 /**
  * \brief default constructor
  *
@@ -73,24 +146,56 @@ qmdiActionGroup *qmdiActionGroupList::operator[](const QString &name) {
  * If the action group requested is not available, a new instance will be
  * created.
  *
+ * Groups are found using a hash, so the cost does not depend on the number of
+ * groups in this list.
+ *
  * \see updateMenu()
  * \see updateToolBar()
  */
 qmdiActionGroup *qmdiActionGroupList::getActionGroup(const QString &name) {
-    qmdiActionGroup *item = nullptr;
+    return findActionGroup(qmdiActionGroup::internName(name), name);
+}
 
-    for (auto &i : actionGroups) {
-        if (i->getName() == name) {
-            return i;
-        }
+/**
+ * \brief get the instance of a action group, by the atom of its name
+ * \param atom the atom of \b name
+ * \param name the action group name, used if a new group is created
+ * \return an instance of an action group
+ *
+ * Used when matching the groups of another list to the groups of this list,
+ * which already know the atom of their names.
+ *
+ * \internal
+ * \see getActionGroup()
+ */
+qmdiActionGroup *qmdiActionGroupList::findActionGroup(int atom, const QString &name) {
+    auto item = findExistingActionGroup(atom);
+    if (item) {
+        return item;
     }
 
     // if menu does not exist, create it
     item = new qmdiActionGroup(name);
     actionGroups.append(item);
+    actionGroupsByAtom.insert(atom, item);
     return item;
 }
 
+/**
+ * \brief get the instance of a action group, without creating it
+ * \param atom the atom of the name of the group
+ * \return the action group, or nullptr if there is no such group in this list
+ *
+ * \internal
+ * \see findActionGroup()
+ */
+qmdiActionGroup *qmdiActionGroupList::findExistingActionGroup(int atom) {
+    if (indexedNameGeneration != qmdiActionGroup::nameGeneration) {
+        reindexGroups();
+    }
+    return actionGroupsByAtom.value(atom);
+}
+
 /**
  * \brief qmdiActionGroupList::addActionGroup
  * \param name how to name the new action group
@@ -109,13 +214,12 @@ qmdiActionGroup *qmdiActionGroupList::getActionGroup(const QString &name) {
  * \see getActionGroup()
  */
 qmdiActionGroup *qmdiActionGroupList::addActionGroup(const QString &name, const QString &after) {
-    auto index = -1;
-    for (auto j = 0; j < actionGroups.size(); j++) {
-        auto ag = actionGroups.at(j);
-        if (ag->getName() == after) {
-            index = j;
-            break;
-        }
+    if (indexedNameGeneration != qmdiActionGroup::nameGeneration) {
+        reindexGroups();
+    }
+    auto index = qsizetype(-1);
+    if (auto afterGroup = actionGroupsByAtom.value(qmdiActionGroup::internName(after))) {
+        index = actionGroups.indexOf(afterGroup);
     }
     auto item = new qmdiActionGroup(name);
     if (index != -1) {
@@ -123,9 +227,32 @@ qmdiActionGroup *qmdiActionGroupList::addActionGroup(const QString &name, const
     } else {
         actionGroups.append(item);
     }
+
+    // a duplicate name is indexed only if it is now the first one in the list
+    auto existing = actionGroupsByAtom.value(item->nameAtom);
+    if (!existing || (index != -1 && index + 1 < actionGroups.indexOf(existing))) {
+        actionGroupsByAtom.insert(item->nameAtom, item);
+    }
     return item;
 }
 
+/**
+ * \brief re-build the index of groups by name
+ *
+ * \internal
+ * \see actionGroupsByAtom
+ */
+void qmdiActionGroupList::reindexGroups() {
+    indexedNameGeneration = qmdiActionGroup::nameGeneration;
+    actionGroupsByAtom.clear();
+    actionGroupsByAtom.reserve(actionGroups.size());
+    for (auto const i : std::as_const(actionGroups)) {
+        if (!actionGroupsByAtom.contains(i->nameAtom)) {
+            actionGroupsByAtom.insert(i->nameAtom, i);
+        }
+    }
+}
+
 /**
  * \brief merge another action group list
  * \param group the new group to merge into this one
@@ -145,10 +272,7 @@ qmdiActionGroup *qmdiActionGroupList::addActionGroup(const QString &name, const
  * \see updateToolBar
  */
 void qmdiActionGroupList::mergeGroupList(qmdiActionGroupList *group) {
-    for (auto &i : group->actionGroups) {
-        auto mine = getActionGroup(i->getName());
-        mine->mergeGroup(i);
-    }
+    mergeGroupLists({group});
 }
 
 /**
@@ -170,12 +294,218 @@ void qmdiActionGroupList::mergeGroupList(qmdiActionGroupList *group) {
  * \see updateToolBar
  */
 void qmdiActionGroupList::unmergeGroupList(qmdiActionGroupList *group) {
-    for (auto &i : group->actionGroups) {
-        auto mine = getActionGroup(i->getName());
-        mine->unmergeGroup(i);
+    unmergeGroupLists({group});
+}
+
+/**
+ * \brief merge several action group lists
+ * \param groups the lists to merge into this one
+ * \since 0.1.1
+ *
+ * This is equivalent to calling mergeGroupList() for each list, but
+ * each group of this list is resolved once, and receives the items of all
+ * the matching groups in a single pass (see qmdiActionGroup::mergeGroups()).
+ *
+ * \see mergeGroupList
+ * \see unmergeGroupLists
+ */
+void qmdiActionGroupList::mergeGroupLists(const QList<qmdiActionGroupList *> &groups) {
+    auto targets = QList<qmdiActionGroup *>();
+    auto pending = QHash<qmdiActionGroup *, QList<qmdiActionGroup *>>();
+    for (auto const list : groups) {
+        if (!list) {
+            continue;
+        }
+        for (auto &i : list->actionGroups) {
+            auto mine = findActionGroup(i->nameAtom, i->name);
+            auto &sources = pending[mine];
+            if (sources.isEmpty()) {
+                targets << mine;
+            }
+            sources << i;
+        }
+    }
+
+    for (auto const mine : std::as_const(targets)) {
+        mine->mergeGroups(pending.value(mine));
+    }
+}
+
+/**
+ * \brief un-merge several action group lists
+ * \param groups the lists to remove from this one
+ * \since 0.1.1
+ *
+ * This is equivalent to calling unmergeGroupList() for each list, but
+ * each group of this list is resolved once, and all the items are removed from
+ * it in a single pass (see qmdiActionGroup::unmergeGroups()).
+ *
+ * \see unmergeGroupList
+ * \see mergeGroupLists
+ */
+void qmdiActionGroupList::unmergeGroupLists(const QList<qmdiActionGroupList *> &groups) {
+    auto targets = QList<qmdiActionGroup *>();
+    auto pending = QHash<qmdiActionGroup *, QList<const qmdiActionGroup *>>();
+    for (auto const list : groups) {
+        if (!list) {
+            continue;
+        }
+        for (auto &i : list->actionGroups) {
+            auto mine = findActionGroup(i->nameAtom, i->name);
+            auto &sources = pending[mine];
+            if (sources.isEmpty()) {
+                targets << mine;
+            }
+            sources << i;
+        }
+    }
+
+    for (auto const mine : std::as_const(targets)) {
+        mine->unmergeGroups(pending.value(mine));
+    }
+}
+
+/**
+ * \brief displays another list on top of this list
+ * \param list the list to display, or nullptr to remove the overlay
+ * \since 0.1.1
+ *
+ * Each group of \b list is set as the overlay of the group with the same
+ * name in this list (see qmdiActionGroup::setOverlay()). The result is
+ * displayed as if \b list has been merged using mergeGroupList(), but this
+ * list is not modified, and the items of each overlay are computed only the
+ * first time it is displayed. Replacing one overlay with another costs
+ * O(number of groups), regardless of the number of actions in them.
+ *
+ * Only one list can be displayed on top of this list, setting a new overlay
+ * replaces the previous one.
+ *
+ * Groups of \b list which have no counterpart in this list are added to
+ * this list, as mergeGroupList() would do, unless they are empty. Empty
+ * groups of the overlay do not create empty menus or toolbars.
+ *
+ * \see getOverlay()
+ * \see dropOverlay()
+ * \see qmdiHost::activateClient()
+ */
+void qmdiActionGroupList::setOverlay(const qmdiActionGroupList *list) {
+    if (overlay == list) {
+        return;
+    }
+
+    for (auto const mine : std::as_const(overlaidGroups)) {
+        mine->setOverlay(nullptr);
+    }
+    overlaidGroups.clear();
+    overlay = list;
+    if (!list) {
+        return;
+    }
+
+    for (auto const i : list->actionGroups) {
+        auto mine = findExistingActionGroup(i->nameAtom);
+        if (!mine) {
+            if (i->empty()) {
+                continue;
+            }
+            mine = findActionGroup(i->nameAtom, i->name);
+        }
+        mine->setOverlay(i);
+        overlaidGroups << mine;
+    }
+}
+
+/**
+ * \fn qmdiActionGroupList::getOverlay()
+ * \brief returns the list displayed on top of this list
+ * \return the overlay, or nullptr if no overlay has been set
+ * \since 0.1.1
+ *
+ * \see setOverlay()
+ */
+
+/**
+ * \brief forget the items computed for an overlay
+ * \param list the overlay
+ * \since 0.1.1
+ *
+ * Call this when \b list is about to be destroyed. If it is the current
+ * overlay, the overlay is removed.
+ *
+ * \see setOverlay()
+ * \see qmdiActionGroup::dropOverlay()
+ */
+void qmdiActionGroupList::dropOverlay(const qmdiActionGroupList *list) {
+    if (!list) {
+        return;
+    }
+    if (overlay == list) {
+        setOverlay(nullptr);
+    }
+    for (auto const i : list->actionGroups) {
+        if (auto mine = findExistingActionGroup(i->nameAtom)) {
+            mine->dropOverlay(i);
+        }
     }
 }
 
+/**
+ * \brief returns the modification stamp of this list
+ * \return the newest generation of all the groups in this list
+ * \since 0.1.1
+ *
+ * Group generations are taken from a process wide counter, so the newest one
+ * changes every time any group of this list is modified, or a new group is
+ * added to the list. Renderers use this value to skip work when nothing
+ * changed since the last update.
+ *
+ * \see qmdiActionGroup::getGeneration()
+ */
+quint64 qmdiActionGroupList::getGeneration() const {
+    auto generation = quint64(0);
+    for (auto const i : actionGroups) {
+        generation = qMax(generation, i->getGeneration());
+    }
+    return generation;
+}
+
+/**
+ * \fn qmdiActionGroupList::reserve()
+ * \brief make room for a number of groups
+ * \param size the number of groups this list will hold
+ * \since 0.1.1
+ *
+ * \see qmdiActionGroupLayout::apply()
+ */
+
+/**
+ * \fn qmdiActionGroupList::setLazyMenus()
+ * \brief populate the menus of the menubar only when they are shown
+ * \param lazy true to populate menus on demand
+ * \since 0.1.1
+ *
+ * By default updateMenuBar() fills every menu of the menubar. Most of those
+ * menus are never opened before the next update, so when lazy menus are
+ * enabled the menubar gets placeholder menus instead, and each menu is filled
+ * from its action group just before it is shown, and only if the group has
+ * been modified since the last time it was filled.
+ *
+ * Shortcuts keep working while menus are not populated, as the placeholder
+ * menus still contain the actions which have shortcuts.
+ *
+ * \see qmdiActionGroup::updateLazyMenu()
+ * \see getLazyMenus()
+ */
+
+/**
+ * \fn qmdiActionGroupList::getLazyMenus()
+ * \brief returns whether menus are populated only when they are shown
+ * \return true if lazy menus are enabled
+ * \since 0.1.1
+ *
+ * \see setLazyMenus()
+ */
+
 /**
  * \brief update a QMenuBar from the definitions on this action group list
  * \param menubar a QMenuBar to be updated
@@ -189,21 +519,82 @@ void qmdiActionGroupList::unmergeGroupList(qmdiActionGroupList *group) {
  *
  * You cannot generate items into a QMenuBar "by hand" and then "add"
  * the definitions on this class.
+ *
+ * The menubar remembers the generation of this list it displays (see
+ * getGeneration()). If no group has been modified since, the menubar is
+ * not touched.
+ *
+ * The menu of each group is kept by this list, and re-used on the next
+ * update: only the groups which have been modified are updated, and the
+ * menus are re-ordered in place. A group which becomes empty has its menu
+ * removed from the menubar, but the menu is kept for when the group gets new
+ * items. Menus are owned by the menubar. Menus are kept for each menubar,
+ * so the same list can be displayed in several windows.
+ *
+ * When lazy menus are enabled (see setLazyMenus()) the menubar gets
+ * placeholder menus, which are populated only when shown.
  */
 QMenuBar *qmdiActionGroupList::updateMenuBar(QMenuBar *menubar) {
+    auto generation = getGeneration();
     if (menubar) {
-        menubar->clear();
+        if (menubar->property("qmdiGeneration").toULongLong() == generation &&
+            menubar->property("qmdiLazyMenus").toBool() == lazyMenus) {
+            return menubar;
+        }
     } else {
         menubar = new QMenuBar(menubar);
     }
 
-    for (auto &i : actionGroups) {
-        auto m = i->updateMenu();
-        if (m) {
-            menubar->addMenu(m);
+    // menubars which have been destroyed
+    for (auto it = groupMenus.begin(); it != groupMenus.end();) {
+        if (it->menubar.isNull()) {
+            it = groupMenus.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    auto &cache = groupMenus[menubar];
+    if (cache.menubar != menubar) {
+        cache.menubar = menubar;
+        cache.menus.clear();
+    }
+
+    auto menuActions = QList<QAction *>();
+    auto visited = QSet<const qmdiActionGroup *>();
+    menuActions.reserve(actionGroups.size());
+    for (auto const i : std::as_const(actionGroups)) {
+        visited.insert(i);
+        if (i->displayedItems().isEmpty()) {
+            continue;
+        }
+
+        auto menu = cache.menus.value(i);
+        if (menu && menu->parent() != menubar) {
+            menu = nullptr;
+        }
+        auto m = lazyMenus ? i->updateLazyMenu(menu) : i->updateMenu(menu);
+        if (m != menu) {
+            m->setParent(menubar, m->windowFlags());
+            cache.menus.insert(i, m);
         }
+        menuActions << m->menuAction();
     }
 
+    // menus of groups which are no longer in this list
+    for (auto it = cache.menus.begin(); it != cache.menus.end();) {
+        if (visited.contains(it.key())) {
+            ++it;
+            continue;
+        }
+        delete it.value().data();
+        it = cache.menus.erase(it);
+    }
+
+    qmdiActionGroup::syncActions(menubar, menuActions);
+    menubar->setProperty("qmdiGeneration", generation);
+    menubar->setProperty("qmdiLazyMenus", lazyMenus);
+
     return menubar;
 }
 
@@ -219,72 +610,135 @@ QMenuBar *qmdiActionGroupList::updateMenuBar(QMenuBar *menubar) {
  * will be returned. This method is similar to updateMenuBar() with
  * the difference that the actio group list is converted to a single popup menu.
  *
+ * The sub menus are children of the popup menu, and are re-used the next time
+ * the same popup menu is updated. Only sub menus of groups which have been
+ * modified are updated, and if no group has been modified the popup menu is
+ * returned untouched.
  */
 QMenu *qmdiActionGroupList::updatePopMenu(QMenu *popupMenu) {
+    auto generation = getGeneration();
     if (popupMenu) {
-        popupMenu->clear();
+        if (popupMenu->property("qmdiGeneration").toULongLong() == generation) {
+            return popupMenu;
+        }
     } else {
         popupMenu = new QMenu(popupMenu);
     }
 
-    for (auto &i : actionGroups) {
-        auto const m = i->updateMenu(nullptr, true);
-        if (m) {
-            popupMenu->addMenu(m);
+    auto subMenus = QHash<quintptr, QMenu *>();
+    for (auto m : popupMenu->findChildren<QMenu *>(Qt::FindDirectChildrenOnly)) {
+        auto group = m->property("qmdiGroup");
+        if (group.isValid()) {
+            subMenus.insert(quintptr(group.toULongLong()), m);
         }
     }
 
+    auto menuActions = QList<QAction *>();
+    menuActions.reserve(actionGroups.size());
+    for (auto const i : std::as_const(actionGroups)) {
+        auto menu = subMenus.take(quintptr(i));
+        if (i->displayedItems().isEmpty()) {
+            continue;
+        }
+
+        auto m = i->updateMenu(menu, true);
+        if (m != menu) {
+            m->setParent(popupMenu, m->windowFlags());
+            m->setProperty("qmdiGroup", quint64(quintptr(i)));
+        }
+        menuActions << m->menuAction();
+    }
+
+    // sub menus of groups which are no longer in this list
+    qDeleteAll(subMenus);
+
+    qmdiActionGroup::syncActions(popupMenu, menuActions);
+    popupMenu->setProperty("qmdiGeneration", generation);
+
     return popupMenu;
 }
 
 /**
- * \brief update a list of QToolBars from the definitions on this action group
- * list \param window the window in which the toolbars should be place \param
- * toolbars a list o toolbars available on the main window \return a list of
- * toolbars which has been created from this action group list
+ * \brief update the toolbars of a window from the definitions on this list
+ * \param window the window in which the toolbars should be placed
+ * \param withWidgets false to leave the widgets of the groups out
+ * \return the toolbars displaying the groups of this list, in order
  *
  * This function generates from the definitions on this class a valid list of
  * QToolBar which will be showed on the \c window .
  *
- * If the \c toolbars array will be nullptr, a new one will be allocated for
- * you. When merging toolbars if a break is defined, a break will be added by
- * this method.
+ * The toolbar of each group is kept by this list (for each window), so
+ * finding it does not depend on the number of toolbars, and the same toolbar
+ * is used even if the group has been renamed. New toolbars are added to the window, and when
+ * merging toolbars if a break is defined, a break will be added by
+ * this method. Toolbars are owned by the window, toolbars of groups which are
+ * no longer in this list are deleted.
  *
  * While you can add toolbars "manually" to your main window, it's not
  * recommended because new actions will not get merged into your toolbar.
  * Instead you might get 2 toolbars with a similar name.
+ *
+ * Toolbars whose group has not been modified since the last update are
+ * skipped, see qmdiActionGroup::updateToolBar(). A widget can be displayed
+ * in a single window, so when updating several windows from the same list,
+ * pass \b withWidgets as true for only one of them.
  */
-QList<QToolBar *> *qmdiActionGroupList::updateToolBar(QList<QToolBar *> *toolbars,
-                                                      QMainWindow *window) {
-    if (toolbars == nullptr) {
-        toolbars = new QList<QToolBar *>;
+QList<QToolBar *> qmdiActionGroupList::updateToolBar(QMainWindow *window, bool withWidgets) {
+    // windows which have been destroyed
+    for (auto it = groupToolBars.begin(); it != groupToolBars.end();) {
+        if (it->window.isNull()) {
+            it = groupToolBars.erase(it);
+        } else {
+            ++it;
+        }
     }
 
-    for (auto const i : actionGroups) {
-        QToolBar *tb = nullptr;
-        auto actionName = i->getName();
-
-        // find the correct toolbar
-        for (auto const &b : std::as_const(*toolbars)) {
-            if (b->windowTitle() == actionName) {
-                tb = b;
-                break;
-            }
+    auto &cache = groupToolBars[window];
+    if (cache.window != window) {
+        cache.window = window;
+        cache.toolbars.clear();
+    }
+
+    auto toolbars = QList<QToolBar *>();
+    auto visited = QSet<const qmdiActionGroup *>();
+    toolbars.reserve(actionGroups.size());
+    for (auto const i : std::as_const(actionGroups)) {
+        visited.insert(i);
+        QToolBar *tb = cache.toolbars.value(i);
+        if (tb && tb->parent() != window) {
+            tb = nullptr;
         }
 
         // if none found, create one
         if (tb == nullptr) {
+            auto actionName = i->getName();
             tb = new QToolBar(actionName, window);
             tb->setObjectName(actionName);
-            *toolbars << tb;
+            cache.toolbars.insert(i, tb);
             window->addToolBar(tb);
             if (i->breakAfter) {
                 window->addToolBarBreak();
             }
+        } else if (tb->objectName() != i->getName()) {
+            // the group has been renamed, QMainWindow::saveState() uses this name
+            auto actionName = i->getName();
+            tb->setObjectName(actionName);
+            tb->setWindowTitle(actionName);
         }
 
         // merge it with the corresponding group list
-        i->updateToolBar(tb);
+        i->updateToolBar(tb, withWidgets);
+        toolbars << tb;
+    }
+
+    // toolbars of groups which are no longer in this list
+    for (auto it = cache.toolbars.begin(); it != cache.toolbars.end();) {
+        if (visited.contains(it.key())) {
+            ++it;
+            continue;
+        }
+        delete it.value().data();
+        it = cache.toolbars.erase(it);
     }
 
     return toolbars;
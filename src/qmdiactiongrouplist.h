@@ -8,7 +8,10 @@
  * \see qmdiActionGroupList
  */
 
+#include <QHash>
 #include <QList>
+#include <QPointer>
+#include <QString>
 
 class QWidget;
 class QToolBar;
@@ -33,15 +36,46 @@ class qmdiActionGroupList {
     qmdiActionGroup *addActionGroup(const QString &name, const QString &after);
     void mergeGroupList(qmdiActionGroupList *group);
     void unmergeGroupList(qmdiActionGroupList *group);
+    void mergeGroupLists(const QList<qmdiActionGroupList *> &groups);
+    void unmergeGroupLists(const QList<qmdiActionGroupList *> &groups);
+    void setOverlay(const qmdiActionGroupList *list);
+    const qmdiActionGroupList *getOverlay() const { return overlay; }
+    void dropOverlay(const qmdiActionGroupList *list);
 
     QMenuBar *updateMenuBar(QMenuBar *menubar);
     QMenu *updatePopMenu(QMenu *popupMenu);
-    QList<QToolBar *> *updateToolBar(QList<QToolBar *> *toolbars, QMainWindow *window);
+    QList<QToolBar *> updateToolBar(QMainWindow *window, bool withWidgets = true);
 
     void addActionsToWidget(QWidget *widget);
     void removeActionsFromWidget(QWidget *widget);
     int size() const { return actionGroups.size(); }
+    void reserve(qsizetype size) {
+        actionGroups.reserve(size);
+        actionGroupsByAtom.reserve(size);
+    }
+    quint64 getGeneration() const;
+    void setLazyMenus(bool lazy) { lazyMenus = lazy; }
+    bool getLazyMenus() const { return lazyMenus; }
 
   private:
+    qmdiActionGroup *findActionGroup(int atom, const QString &name);
+    qmdiActionGroup *findExistingActionGroup(int atom);
+    void reindexGroups();
+
     QList<qmdiActionGroup *> actionGroups;
+    QHash<int, qmdiActionGroup *> actionGroupsByAtom;
+    quint64 indexedNameGeneration = 0;
+    struct MenuBarMenus {
+        QPointer<QMenuBar> menubar;
+        QHash<const qmdiActionGroup *, QPointer<QMenu>> menus;
+    };
+    struct WindowToolBars {
+        QPointer<QMainWindow> window;
+        QHash<const qmdiActionGroup *, QPointer<QToolBar>> toolbars;
+    };
+    QHash<const QMenuBar *, MenuBarMenus> groupMenus;
+    QHash<const QMainWindow *, WindowToolBars> groupToolBars;
+    const qmdiActionGroupList *overlay = nullptr;
+    QList<qmdiActionGroup *> overlaidGroups;
+    bool lazyMenus = false;
 };
@@ -249,23 +249,14 @@ QString qmdiClient::mdiClientFileName() { return QString(); }
  * to announce that this client has been merged at the
  * host passed as a parameter.
  *
- * This function adds adds all menu/toolbar actions to the host. Please do call this method
- * when re-implementing.
+ * The host adds all menu/toolbar actions to the host and client widgets by
+ * itself, right after calling this method. The default implementation
+ * does nothing. Please do call this method when re-implementing.
  *
  * \see qmdiHost::mergeClient()
  * \since 0.0.5
  */
-void qmdiClient::on_client_merged(qmdiHost *host) {
-    if (auto w = dynamic_cast<QWidget *>(host)) {
-        menus.addActionsToWidget(w);
-        toolbars.addActionsToWidget(w);
-    }
-
-    if (auto w = dynamic_cast<QWidget *>(this)) {
-        menus.addActionsToWidget(w);
-        toolbars.addActionsToWidget(w);
-    }
-}
+void qmdiClient::on_client_merged(qmdiHost *host) { Q_UNUSED(host); }
 
 /**
  * \brief Callback function to announce that the client has been unmerged
@@ -275,23 +266,14 @@ void qmdiClient::on_client_merged(qmdiHost *host) {
  * to announce that this client has been merged at the
  * host passed as a parameter.
  *
- * This function adds removes all menu/toolbar actions to the host. Please do call this method
- * when re-implementing.
+ * The host removes the menu/toolbar actions from the host and client widgets
+ * by itself, right after calling this method. The default implementation
+ * does nothing. Please do call this method when re-implementing.
  *
  * \see qmdiHost::unmergeClient()
  * \since 0.0.5
  */
-void qmdiClient::on_client_unmerged(qmdiHost *host) {
-    if (auto w = dynamic_cast<QWidget *>(host)) {
-        menus.removeActionsFromWidget(w);
-        toolbars.removeActionsFromWidget(w);
-    }
-
-    if (auto w = dynamic_cast<QWidget *>(this)) {
-        menus.removeActionsFromWidget(w);
-        toolbars.removeActionsFromWidget(w);
-    }
-}
+void qmdiClient::on_client_unmerged(qmdiHost *host) { Q_UNUSED(host); }
 
 /**
  * @brief Return internal state
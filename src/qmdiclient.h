@@ -11,6 +11,7 @@
 // the reason for including this file, and not declare the classes
 // is for the developer using this library - one single include
 #include "qmdiactiongroup.h"
+#include "qmdiactiongrouplayout.h"
 #include "qmdiactiongrouplist.h"
 
 #include <QHash>
@@ -9,7 +9,10 @@
 #include "qmdihost.h"
 #include "qmdiclient.h"
 #include <QAction>
+#include <QActionGroup>
 #include <QMainWindow>
+#include <QSet>
+#include <QTimer>
 
 /**
  * \class qmdiHost
@@ -67,17 +70,209 @@
  */
 
 /**
- * \var qmdiHost::toolBarList
- * \brief internal list of available toolbars
+ * \var qmdiHost::renderedWindows
+ * \brief generation of the menus and toolbars last rendered in each window
  *
- * As Qt4 does not provide an interface for listing the available
- * toolbars, the list is maintained as a separate list.
+ * \internal
+ * \see qmdiActionGroupList::getGeneration()
+ * \see renderGUI()
+ */
+
+/**
+ * \var qmdiHost::renderers
+ * \brief the renderers added by addRenderer()
+ *
+ * \internal
+ */
+
+/**
+ * \var qmdiHost::renderedRenderers
+ * \brief the generations of the menus and toolbars passed to each renderer
+ *
+ * Kept by the host, like renderedWindows, so the same renderer can be added
+ * to several hosts.
+ *
+ * \internal
+ * \see renderGUI()
+ */
+
+/**
+ * \var qmdiHost::renderersPending
+ * \brief true if the renderers should be updated on the next flushGUI()
+ *
+ * \internal
+ */
+
+/**
+ * \var qmdiHost::windows
+ * \brief the windows added by addWindow()
+ *
+ * \internal
+ * \see getWindows()
+ */
+
+/**
+ * \var qmdiHost::activeClient
+ * \brief the client displayed on top of the menus and toolbars
+ *
+ * \internal
+ * \see activateClient()
+ */
+
+/**
+ * \var qmdiHost::mergedClients
+ * \brief the clients merged by mergeClients()
+ *
+ * \internal
+ * A client is displayed while it is in this set or while it is the active
+ * client. It is announced and its actions are attached only when it starts
+ * being displayed, and the opposite is done only when it stops being
+ * displayed.
+ *
+ * \see mergeClients()
+ * \see unmergeClients()
+ */
+
+/**
+ * \var qmdiHost::deferredUpdates
+ * \brief true if updateGUI() only schedules the update
+ *
+ * \internal
+ * \see setDeferredUpdates()
+ */
+
+/**
+ * \var qmdiHost::updateTimer
+ * \brief single shot timer which calls flushGUI() for deferred updates
+ *
+ * Created on the first deferred update, and owned by the host.
+ *
+ * \internal
+ */
+
+/**
+ * \var qmdiHost::pendingWindows
+ * \brief the windows to update on the next flushGUI()
+ *
+ * \internal
+ */
+
+/**
+ * \var qmdiHost::updateDepth
+ * \brief the number of beginUpdate() calls not yet ended
+ *
+ * \internal
+ * \see beginUpdate()
+ */
+
+/**
+ * \var qmdiHost::attachedActions
+ * \brief the actions attached by the host to each widget, with a reference count
+ *
+ * An action is counted once for every merged client that contains it, and is
+ * removed from the widget when the count drops to zero. Widgets modified
+ * between beginUpdate() and endUpdate() are marked as dirty, and are
+ * updated by syncAttachedActions().
+ *
+ * Each entry also watches its action, so the entry of an action which has
+ * been deleted is never mistaken for a new action allocated at the same
+ * address. Such entries are dropped when they are found.
+ *
+ * \internal
+ * \see addActionsToWidget()
+ */
+
+/**
+ * \var qmdiHost::indexedShortcuts
+ * \brief the shortcuts each action had when it was first indexed
  *
- * You should usually not use this list directly.
+ * An action is counted once for every merged client that contains it. The
+ * shortcuts are kept as they were indexed, so the index is updated correctly
+ * even if the shortcuts of the action are modified while merged, or are
+ * modified by shortcut routing. If routing removed some of the shortcuts,
+ * \b routed is set and \b routedShortcuts holds what was left on the action,
+ * so the host gives back only what it took away.
  *
  * \internal
- * \todo how about quering the childs of the main window? it should be possible
- * to remove the toolBarList
+ * \see indexShortcuts()
+ */
+
+/**
+ * \var qmdiHost::shortcutIndex
+ * \brief the actions of merged clients which use each shortcut
+ *
+ * Actions are listed in the order they were merged, once for every client
+ * which contains them.
+ *
+ * \internal
+ * \see getShortcutActions()
+ */
+
+/**
+ * \var qmdiHost::conflictingShortcuts
+ * \brief shortcuts used by more than one action
+ *
+ * \internal
+ * \see getShortcutConflicts()
+ */
+
+/**
+ * \var qmdiHost::shortcutRouting
+ * \brief true if the host decides which action owns a conflicting shortcut
+ *
+ * \internal
+ * \see setShortcutRouting()
+ */
+
+/**
+ * \var qmdiHost::statsEnabled
+ * \brief true if merges and updates are measured
+ *
+ * When the library is built with QMDILIB_NO_STATS this is a constant false,
+ * and the measuring code is removed by the compiler.
+ *
+ * \internal
+ * \see setStatsEnabled()
+ */
+
+/**
+ * \var qmdiHost::stats
+ * \brief the counters returned by getStats()
+ *
+ * \internal
+ */
+
+/**
+ * \var qmdiHost::statsDumpInterval
+ * \brief milliseconds between two dumps of the statistics, 0 to disable
+ *
+ * \internal
+ * \see setStatsDumpInterval()
+ */
+
+/**
+ * \var qmdiHost::statsDumpTimer
+ * \brief time passed since the statistics were last dumped
+ *
+ * \internal
+ */
+
+/**
+ * \struct qmdiHostStats
+ * \brief counters of the work done by a qmdiHost
+ * \since 0.1.1
+ *
+ * Each merge, unmerge and activation counts the clients processed, and the
+ * number of menu and toolbar entries moved in or out of the host
+ * (\b itemsMoved). Activating a client does not move items, see
+ * qmdiHost::activateClient().
+ *
+ * \b updateGUICalls counts all the calls to qmdiHost::updateGUI(), while
+ * \b menusRebuilt and \b toolbarsRebuilt count only the calls which had to
+ * render the menubar or the toolbars. The time spent in each phase is
+ * accumulated in the \b *Nanoseconds fields.
+ *
+ * \see qmdiHost::getStats()
  */
 
 
@@ -86,16 +281,15 @@
  *
  * Construct a qmdiHost instance.
  */
-qmdiHost::qmdiHost() { toolBarList = nullptr; }
+qmdiHost::qmdiHost() {}
 
 /**
  * \brief Default destructor
  *
- * This destructor deletes \b toolBarList
- *
- * \see toolBarList
+ * Destroys the host. Menus and toolbars are owned by the window. Pending
+ * deferred updates are discarded.
  */
-qmdiHost::~qmdiHost() { delete toolBarList; }
+qmdiHost::~qmdiHost() { delete updateTimer; }
 
 /**
  * \brief update the toolbars and menus
@@ -115,159 +309,1316 @@ qmdiHost::~qmdiHost() { delete toolBarList; }
  *
  * Since version 0.0.4, the \b window parameter is optional. This method
  * will try and see it \b this is a QMainWindow, and then update itself.
+ * Since version 0.1.1, all the windows of the host (see getWindows()) and
+ * all its renderers (see addRenderer()) are updated when no window is
+ * passed.
+ *
+ * Only the parts which have been modified since the last call are rendered:
+ * if neither menus nor toolbars changed, this method does nothing. Inside
+ * the menus and toolbars, only groups with a new generation are updated.
+ *
+ * When deferred updates are enabled (see setDeferredUpdates()), this method
+ * only marks the window as needing an update. The update is done once, when
+ * control returns to the event loop, no matter how many times this method
+ * was called. Use flushGUI() to update immediately. The same happens between
+ * beginUpdate() and endUpdate(), where the update is done by endUpdate().
  *
  * \see qmdiActionGroupList
+ * \see qmdiActionGroup::getGeneration()
  */
 void qmdiHost::updateGUI(QMainWindow *window) {
-    // if passed nullptr, lets try another sanity check
+    // if passed nullptr, update all the windows and renderers of this host
+    auto targets = QList<QMainWindow *>();
+    auto withRenderers = window == nullptr && !renderers.isEmpty();
     if (window == nullptr) {
-        window = dynamic_cast<QMainWindow *>(this);
+        targets = getWindows();
+    } else {
+        targets << window;
     }
 
-    if (window == nullptr) {
+    if (targets.isEmpty() && !withRenderers) {
         qDebug("%s - warning, no QMainWindow specified", __FUNCTION__);
         return;
     }
 
-    window->setUpdatesEnabled(false);
-    toolBarList = toolbars.updateToolBar(toolBarList, window);
-    menus.updateMenuBar(window->menuBar());
-    window->setUpdatesEnabled(true);
+    if (statsEnabled) {
+        stats.updateGUICalls++;
+        dumpStats();
+    }
+
+    if (!deferredUpdates && updateDepth == 0) {
+        for (auto target : targets) {
+            renderGUI(target);
+        }
+        if (withRenderers) {
+            for (auto renderer : std::as_const(renderers)) {
+                renderGUI(renderer);
+            }
+        }
+        return;
+    }
+
+    for (auto target : targets) {
+        if (!pendingWindows.contains(target)) {
+            pendingWindows << target;
+        }
+    }
+    renderersPending = renderersPending || withRenderers;
+    if (updateDepth == 0) {
+        scheduleGUI();
+    }
 }
 
 /**
- * \brief merge the toolbars and menus of another MDI client
- * \param client the client to be merged
+ * \brief update the toolbars and menus now, if an update is pending
+ * \since 0.1.1
  *
- * This function is used to merge the toolbars and contents
- * of the MDI client to be merged into this client. The menus
- * and toolbars of the host will be appended to the end
- * of the menus and toolbars of this MDI host.
+ * When deferred updates are enabled, updateGUI() postpones the update to the
+ * next iteration of the event loop. Call this method when the menus and
+ * toolbars are needed right away, for example before restoring the state of
+ * the toolbars with QMainWindow::restoreState().
  *
- * This method will announce the client that it's been merged
- * by calling qmdiClient::on_client_merged()
+ * If no update is pending, this method does nothing. Between beginUpdate()
+ * and endUpdate() this method does nothing either, the update is done by
+ * the last endUpdate().
  *
- * After a call to this function, you should manually call
- * updateGUI.
+ * \see setDeferredUpdates()
+ * \see updateGUI()
+ */
+void qmdiHost::flushGUI() {
+    if (updateDepth > 0) {
+        return;
+    }
+    renderPendingGUI();
+}
+
+/**
+ * \brief starts a batch of modifications to the menus and toolbars
+ * \since 0.1.1
  *
- * Since version 0.0.5 this method also tries to cast the client to a widget,
- * and if it's succesful, it will add all it's menus+toolbars actions to the
- * widget. This way when changing tabs in a qmdiHost (like qmdiTabWidget) and
- * menus are hidden, the actions are still available.
+ * Enabling plugins or restoring a session merges and unmerges many clients in
+ * a row. Until the matching endUpdate(), the host does not render the menus
+ * and toolbars, and does not attach or detach actions from widgets. Calls to
+ * updateGUI() only record that an update is needed. The modifications
+ * themselves (mergeClient(), unmergeClient(), modifying \b menus and
+ * \b toolbars) are done immediately, they are cheap.
  *
- * \see updateGUI
- * \see unmergeClient
- * \see qmdiClient::on_client_merged()
+ * Calls can be nested, the changes are applied by the outermost endUpdate().
+ * Prefer qmdiUpdateGuard, which calls endUpdate() when leaving the scope.
+ *
+ * \see endUpdate()
  */
-void qmdiHost::mergeClient(qmdiClient *client) {
-    if (client == nullptr) {
+void qmdiHost::beginUpdate() { updateDepth++; }
+
+/**
+ * \brief ends a batch of modifications to the menus and toolbars
+ * \since 0.1.1
+ *
+ * When the outermost batch ends, actions of merged clients are attached to
+ * (and detached from) the widgets in a single pass, and if updateGUI() was
+ * called during the batch, the menus and toolbars are rendered once. With
+ * deferred updates (see setDeferredUpdates()), rendering is scheduled
+ * instead.
+ *
+ * \see beginUpdate()
+ */
+void qmdiHost::endUpdate() {
+    if (updateDepth == 0) {
+        qDebug("%s - warning, called without beginUpdate()", __FUNCTION__);
+        return;
+    }
+    if (--updateDepth > 0) {
         return;
     }
 
-    client->on_client_merged(this);
-    menus.mergeGroupList(&client->menus);
-    toolbars.mergeGroupList(&client->toolbars);
-
-    auto w = dynamic_cast<QWidget *>(client);
-    if (!w) {
+    syncAttachedActions();
+    if (pendingWindows.isEmpty() && !renderersPending) {
         return;
     }
-    addActionsToWidget(client->menus, w);
-    addActionsToWidget(client->toolbars, w);
+    if (deferredUpdates) {
+        scheduleGUI();
+    } else {
+        renderPendingGUI();
+    }
 }
 
 /**
- * \brief unmerge the toolbars and menus of another MDI client
- * \param client the client to be unmerged
- *
- * This function is used to un-merge the toolbars and contents
- * of the MDI client to be un-merged into this client. The menus
- * and toolbars of host will be updated, and all the entries
- * defined in the client will be removed.
+ * \class qmdiUpdateGuard
+ * \brief calls qmdiHost::beginUpdate(), and qmdiHost::endUpdate() when destroyed
+ * \since 0.1.1
  *
- * This method will announce the client that it's been unmerged
- * by calling qmdiClient::on_client_unmerged()
+ * \code
+ * {
+ *     auto guard = qmdiUpdateGuard(this);
+ *     for (auto plugin : plugins) {
+ *         mergeClient(plugin);
+ *     }
+ *     updateGUI();
+ * } // the GUI is updated here
+ * \endcode
  *
- * After a call to this function, you should manually call
- * updateGUI.
+ * \see qmdiHost::beginUpdate()
+ */
+
+/**
+ * \fn qmdiHost::isUpdating()
+ * \brief returns true between beginUpdate() and the matching endUpdate()
+ * \since 0.1.1
+ */
+
+/**
+ * \brief starts the timer of a deferred update
  *
- * Since version 0.0.5 this method also tries to cast the client to a widget,
- * and if it's succesful, it will remove all it's menus+toolbars actions from
- * the widget.
+ * \internal
+ * \see flushGUI()
+ */
+void qmdiHost::scheduleGUI() {
+    if (updateTimer == nullptr) {
+        updateTimer = new QTimer;
+        updateTimer->setSingleShot(true);
+        updateTimer->setInterval(0);
+        QObject::connect(updateTimer, &QTimer::timeout, updateTimer, [this]() { flushGUI(); });
+    }
+    if (!updateTimer->isActive()) {
+        updateTimer->start();
+    }
+}
+
+/**
+ * \brief renders the pending update, if any
  *
- * \see updateGUI
- * \see mergeClient
- * \see qmdiClient::on_client_unmerged()
+ * \internal
+ * \see flushGUI()
  */
-void qmdiHost::unmergeClient(qmdiClient *client) {
-    if (client == nullptr) {
-        return;
+void qmdiHost::renderPendingGUI() {
+    if (updateTimer) {
+        updateTimer->stop();
+    }
+    auto pending = pendingWindows;
+    pendingWindows.clear();
+    for (auto &window : pending) {
+        if (window) {
+            renderGUI(window);
+        }
+    }
+    if (renderersPending) {
+        renderersPending = false;
+        for (auto renderer : std::as_const(renderers)) {
+            renderGUI(renderer);
+        }
     }
+}
 
-    menus.unmergeGroupList(&client->menus);
-    toolbars.unmergeGroupList(&client->toolbars);
-    client->on_client_unmerged(this);
+/**
+ * \brief enables or disables deferred updates
+ * \param deferred true to coalesce calls to updateGUI()
+ * \since 0.1.1
+ *
+ * Closing a tab or enabling a plugin calls updateGUI() several times in a
+ * row. With deferred updates, those calls only schedule a single update,
+ * which is done when control returns to the event loop. Deferred updates are
+ * disabled by default.
+ *
+ * Disabling deferred updates does a pending update immediately.
+ *
+ * \see flushGUI()
+ */
+void qmdiHost::setDeferredUpdates(bool deferred) {
+    deferredUpdates = deferred;
+    if (!deferred) {
+        flushGUI();
+    }
+}
 
-    auto w = dynamic_cast<QWidget *>(client);
-    if (!w) {
+/**
+ * \brief displays the menus and toolbars of this host in a renderer
+ * \param renderer the renderer to add, owned by the caller
+ * \since 0.1.1
+ *
+ * Renderers are updated by updateGUI(), when it's called without a window.
+ * A host with a renderer and no window does not create any widget, which is
+ * useful for tests and benchmarks, see qmdiNullRenderer.
+ *
+ * \see removeRenderer()
+ */
+void qmdiHost::addRenderer(qmdiRenderer *renderer) {
+    if (renderer == nullptr || renderers.contains(renderer)) {
         return;
     }
-    removeActionsFromWidget(client->menus, w);
-    removeActionsFromWidget(client->toolbars, w);
+    renderedRenderers.insert(renderer, {});
+    renderers << renderer;
 }
 
 /**
- * \brief add a list of actions to a widget
- * \param agl the action group list to look for actions in
- * \param w the target widget
+ * \brief stops displaying the menus and toolbars of this host in a renderer
+ * \param renderer the renderer to remove
+ * \since 0.1.1
  *
- * This method adds all the actions in the action group list provided, to the
- * widget passed on.
+ * \see addRenderer()
+ */
+void qmdiHost::removeRenderer(qmdiRenderer *renderer) {
+    renderers.removeAll(renderer);
+    renderedRenderers.remove(renderer);
+}
+
+/**
+ * \fn qmdiHost::getRenderers()
+ * \brief returns the renderers added by addRenderer()
+ * \since 0.1.1
+ */
+
+/**
+ * \fn qmdiHost::getDeferredUpdates()
+ * \brief returns true if calls to updateGUI() are coalesced
+ * \since 0.1.1
  *
- * It's used internally by mergeClient()
+ * \see setDeferredUpdates()
+ */
+
+/**
+ * \brief displays the menus and toolbars of this host in another window
+ * \param window the window to add
+ * \since 0.1.1
  *
- * \see mergeClient
- * \see QWidget::addAction
+ * A host can drive several windows. The menus and toolbars, and the merged
+ * clients, are kept once in the host. Each window gets its own menubar menus
+ * and toolbars, which display the same actions. The actions attached to the
+ * host for their shortcuts (see mergeClient()) are attached to all windows.
+ *
+ * A QWidget added to a toolbar group (see qmdiActionGroup::addWidget()) can
+ * only be displayed once. Widgets are displayed only in the primary window,
+ * which is the first one returned by getWindows(): \b this if it is a
+ * QMainWindow, otherwise the first window added. The toolbars of the other
+ * windows display only the actions.
+ *
+ * If \b this is a QMainWindow, there is no need to add it. Call updateGUI()
+ * after adding windows. Windows which are destroyed are removed
+ * automatically.
+ *
+ * \see removeWindow()
+ * \see getWindows()
  */
-void qmdiHost::addActionsToWidget(const qmdiActionGroupList &agl, QWidget *w) {
-    for (auto &g : agl.actionGroups) {
-        for (auto &o : g->actionGroupItems) {
-            auto a = qobject_cast<QAction *>(o);
-            if (!a) {
-                continue;
-            }
-            if (w->actions().contains(a)) {
-                continue;
-            }
-            w->addAction(a);
+void qmdiHost::addWindow(QMainWindow *window) {
+    if (window == nullptr || getWindows().contains(window)) {
+        return;
+    }
+
+    // the actions currently attached to the other windows
+    for (auto w : hostWidgets()) {
+        auto attached = attachedActions.constFind(w);
+        if (attached == attachedActions.constEnd() || attached->widget != w) {
+            continue;
+        }
+        auto copy = *attached;
+        copy.widget = window;
+        copy.dirty = true;
+        attachedActions.insert(window, copy);
+        if (updateDepth == 0) {
+            syncAttachedActions();
         }
+        break;
     }
+    windows << window;
 }
 
 /**
- * \brief remove a list of actions from a widget
- * \param agl the action group list to look for actions in
- * \param w the target widget
+ * \brief stops displaying the menus and toolbars of this host in a window
+ * \param window the window to remove
+ * \since 0.1.1
  *
- * This method removes all the actions in the action group list provided, to the
- * widget passed on.
+ * The window is no longer updated by updateGUI(). Its menus, toolbars and
+ * actions are left as they are.
  *
- * It's used internally by unmergeClient()
+ * \see addWindow()
+ */
+void qmdiHost::removeWindow(QMainWindow *window) {
+    windows.removeAll(window);
+    pendingWindows.removeAll(window);
+    renderedWindows.remove(window);
+    attachedActions.remove(window);
+}
+
+/**
+ * \brief returns the windows displaying the menus and toolbars of this host
+ * \return \b this if it is a QMainWindow, followed by the windows added by
+ *         addWindow()
+ * \since 0.1.1
  *
- * \see unmergeClient
- * \see QWidget::addAction
+ * \see addWindow()
  */
-void qmdiHost::removeActionsFromWidget(const qmdiActionGroupList &agl, QWidget *w) {
-    for (auto &g : agl.actionGroups) {
-        for (auto &o : g->actionGroupItems) {
-            auto a = qobject_cast<QAction *>(o);
-            if (!a) {
-                continue;
-            }
-            if (!w->actions().contains(a)) {
-                continue;
-            }
-            w->removeAction(a);
+QList<QMainWindow *> qmdiHost::getWindows() {
+    auto list = QList<QMainWindow *>();
+    if (auto window = dynamic_cast<QMainWindow *>(this)) {
+        list << window;
+    }
+    for (auto &window : std::as_const(windows)) {
+        if (window && !list.contains(window)) {
+            list << window;
         }
     }
+    return list;
+}
+
+/**
+ * \brief renders the menus and toolbars which changed into a window
+ * \param window the window to update
+ *
+ * Each window remembers the generations it displays, so windows are
+ * updated independently. The menus and toolbars of the host are shared by
+ * all windows, only the widgets displaying them are created per window.
+ * Toolbar widgets are given only to the primary window (see addWindow()).
+ *
+ * \internal
+ * \see updateGUI()
+ */
+void qmdiHost::renderGUI(QMainWindow *window) {
+    // windows which have been destroyed
+    for (auto it = renderedWindows.begin(); it != renderedWindows.end();) {
+        if (it->window.isNull()) {
+            it = renderedWindows.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    auto &rendered = renderedWindows[window];
+    rendered.window = window;
+    auto &menusGeneration = rendered.menusGeneration;
+    auto &toolbarsGeneration = rendered.toolbarsGeneration;
+    auto newMenusGeneration = menus.getGeneration();
+    auto newToolbarsGeneration = toolbars.getGeneration();
+    if (newMenusGeneration == menusGeneration && newToolbarsGeneration == toolbarsGeneration) {
+        return;
+    }
+
+    auto timer = QElapsedTimer();
+    window->setUpdatesEnabled(false);
+    if (newToolbarsGeneration != toolbarsGeneration) {
+        if (statsEnabled) {
+            timer.start();
+        }
+        toolbars.updateToolBar(window, window == getWindows().constFirst());
+        toolbarsGeneration = newToolbarsGeneration;
+        if (statsEnabled) {
+            stats.toolbarsRebuilt++;
+            stats.toolbarsNanoseconds += timer.nsecsElapsed();
+        }
+    }
+    if (newMenusGeneration != menusGeneration) {
+        if (statsEnabled) {
+            timer.start();
+        }
+        menus.updateMenuBar(window->menuBar());
+        menusGeneration = newMenusGeneration;
+        if (statsEnabled) {
+            stats.menusRebuilt++;
+            stats.menusNanoseconds += timer.nsecsElapsed();
+        }
+    }
+    window->setUpdatesEnabled(true);
+}
+
+/**
+ * \brief passes the menus and toolbars which changed to a renderer
+ * \param renderer the renderer to update
+ *
+ * \internal
+ * \see updateGUI()
+ */
+void qmdiHost::renderGUI(qmdiRenderer *renderer) {
+    auto &rendered = renderedRenderers[renderer];
+    auto newMenusGeneration = menus.getGeneration();
+    auto newToolbarsGeneration = toolbars.getGeneration();
+    auto timer = QElapsedTimer();
+    if (newToolbarsGeneration != rendered.toolbarsGeneration) {
+        if (statsEnabled) {
+            timer.start();
+        }
+        renderer->updateToolBars(toolbars);
+        rendered.toolbarsGeneration = newToolbarsGeneration;
+        if (statsEnabled) {
+            stats.toolbarsRebuilt++;
+            stats.toolbarsNanoseconds += timer.nsecsElapsed();
+        }
+    }
+    if (newMenusGeneration != rendered.menusGeneration) {
+        if (statsEnabled) {
+            timer.start();
+        }
+        renderer->updateMenus(menus);
+        rendered.menusGeneration = newMenusGeneration;
+        if (statsEnabled) {
+            stats.menusRebuilt++;
+            stats.menusNanoseconds += timer.nsecsElapsed();
+        }
+    }
+}
+
+/**
+ * \brief merge the toolbars and menus of another MDI client
+ * \param client the client to be merged
+ *
+ * This function is used to merge the toolbars and contents
+ * of the MDI client to be merged into this client. The menus
+ * and toolbars of the host will be appended to the end
+ * of the menus and toolbars of this MDI host.
+ *
+ * This method will announce the client that it's been merged
+ * by calling qmdiClient::on_client_merged()
+ *
+ * After a call to this function, you should manually call
+ * updateGUI.
+ *
+ * Since version 0.0.5 this method also tries to cast the client to a widget,
+ * and if it's succesful, it will add all it's menus+toolbars actions to the
+ * widget. This way when changing tabs in a qmdiHost (like qmdiTabWidget) and
+ * menus are hidden, the actions are still available.
+ *
+ * \see updateGUI
+ * \see unmergeClient
+ * \see qmdiClient::on_client_merged()
+ */
+void qmdiHost::mergeClient(qmdiClient *client) {
+    if (client == nullptr) {
+        return;
+    }
+    mergeClients({client});
+}
+
+/**
+ * \brief unmerge the toolbars and menus of another MDI client
+ * \param client the client to be unmerged
+ *
+ * This function is used to un-merge the toolbars and contents
+ * of the MDI client to be un-merged into this client. The menus
+ * and toolbars of host will be updated, and all the entries
+ * defined in the client will be removed.
+ *
+ * This method will announce the client that it's been unmerged
+ * by calling qmdiClient::on_client_unmerged()
+ *
+ * After a call to this function, you should manually call
+ * updateGUI.
+ *
+ * Since version 0.0.5 this method also tries to cast the client to a widget,
+ * and if it's succesful, it will remove all it's menus+toolbars actions from
+ * the widget.
+ *
+ * \see updateGUI
+ * \see mergeClient
+ * \see qmdiClient::on_client_unmerged()
+ */
+void qmdiHost::unmergeClient(qmdiClient *client) {
+    if (client == nullptr) {
+        return;
+    }
+    unmergeClients({client});
+}
+
+/**
+ * \brief merge the toolbars and menus of several MDI clients
+ * \param clients the clients to be merged
+ * \since 0.1.1
+ *
+ * This is equivalent to calling mergeClient() for each client, but all the
+ * menus and toolbars are merged in a single pass (see
+ * qmdiActionGroupList::mergeGroupLists()). Use this when adding many clients
+ * at once, for example when loading plugins at startup.
+ *
+ * After a call to this function, you should manually call
+ * updateGUI.
+ *
+ * The active client (see activateClient()) is already displayed, and is not
+ * merged again. Merging a client which is already merged does nothing.
+ *
+ * \see mergeClient
+ * \see unmergeClients
+ */
+void qmdiHost::mergeClients(const QList<qmdiClient *> &clients) {
+    auto timer = QElapsedTimer();
+    if (statsEnabled) {
+        timer.start();
+    }
+
+    auto clientMenus = QList<qmdiActionGroupList *>();
+    auto clientToolbars = QList<qmdiActionGroupList *>();
+    clientMenus.reserve(clients.size());
+    clientToolbars.reserve(clients.size());
+    auto merged = QList<qmdiClient *>();
+    for (auto const client : clients) {
+        if (client == nullptr || client == activeClient || mergedClients.contains(client)) {
+            continue;
+        }
+        mergedClients.insert(client);
+        merged << client;
+        client->on_client_merged(this);
+        clientMenus << &client->menus;
+        clientToolbars << &client->toolbars;
+    }
+    menus.mergeGroupLists(clientMenus);
+    toolbars.mergeGroupLists(clientToolbars);
+
+    for (auto const client : std::as_const(merged)) {
+        attachActions(client);
+    }
+
+    if (statsEnabled) {
+        stats.merges += clientMenus.size();
+        stats.itemsMoved += itemCount(clientMenus) + itemCount(clientToolbars);
+        stats.mergeNanoseconds += timer.nsecsElapsed();
+    }
+}
+
+/**
+ * \brief unmerge the toolbars and menus of several MDI clients
+ * \param clients the clients to be unmerged
+ * \since 0.1.1
+ *
+ * This is equivalent to calling unmergeClient() for each client, but all the
+ * menus and toolbars are un-merged in a single pass (see
+ * qmdiActionGroupList::unmergeGroupLists()).
+ *
+ * After a call to this function, you should manually call
+ * updateGUI.
+ *
+ * If one of the clients is the active client (see activateClient()), it is
+ * deactivated. The menus and toolbars computed for those clients by
+ * activateClient() are released. Clients which are neither merged nor
+ * active are not announced, and their actions are not detached, so closing
+ * a client in the background does not affect the actions it shares with the
+ * active client.
+ *
+ * \see unmergeClient
+ * \see mergeClients
+ */
+void qmdiHost::unmergeClients(const QList<qmdiClient *> &clients) {
+    auto timer = QElapsedTimer();
+    if (statsEnabled) {
+        timer.start();
+    }
+
+    auto clientMenus = QList<qmdiActionGroupList *>();
+    auto clientToolbars = QList<qmdiActionGroupList *>();
+    clientMenus.reserve(clients.size());
+    clientToolbars.reserve(clients.size());
+    auto unmerged = QList<qmdiClient *>();
+    for (auto const client : clients) {
+        if (client == nullptr) {
+            continue;
+        }
+        auto displayed = false;
+        if (client == activeClient) {
+            menus.setOverlay(nullptr);
+            toolbars.setOverlay(nullptr);
+            activeClient = nullptr;
+            displayed = true;
+        }
+        if (mergedClients.remove(client)) {
+            clientMenus << &client->menus;
+            clientToolbars << &client->toolbars;
+            displayed = true;
+        }
+        if (displayed) {
+            unmerged << client;
+        }
+        menus.dropOverlay(&client->menus);
+        toolbars.dropOverlay(&client->toolbars);
+    }
+    menus.unmergeGroupLists(clientMenus);
+    toolbars.unmergeGroupLists(clientToolbars);
+
+    for (auto const client : std::as_const(unmerged)) {
+        client->on_client_unmerged(this);
+        detachActions(client);
+    }
+
+    if (statsEnabled) {
+        stats.unmerges += clientMenus.size();
+        stats.itemsMoved += itemCount(clientMenus) + itemCount(clientToolbars);
+        stats.unmergeNanoseconds += timer.nsecsElapsed();
+    }
+}
+
+/**
+ * \brief display the menus and toolbars of a client, replacing the previous one
+ * \param client the client to display, or nullptr to display only the host
+ * \since 0.1.1
+ *
+ * This is what an MDI server calls when the user selects another client
+ * (for example, when switching tabs in qmdiTabWidget). It has the same effect
+ * as un-merging the previous active client and merging the new one, but the
+ * menus and toolbars of the host are not modified. Instead, the client is
+ * displayed as an overlay (see qmdiActionGroupList::setOverlay()), which is
+ * computed the first time the client is activated. Switching between clients
+ * costs the same regardless of the number of actions each client defines.
+ *
+ * The clients are announced with qmdiClient::on_client_merged() and
+ * qmdiClient::on_client_unmerged(), as with mergeClient() and unmergeClient().
+ * Call unmergeClient() before destroying a client, to release its overlay.
+ * A client which is already merged with mergeClient() stays merged, and is
+ * not displayed again as an overlay.
+ *
+ * After a call to this function, you should manually call
+ * updateGUI.
+ *
+ * \see getActiveClient()
+ * \see mergeClient
+ * \see unmergeClient
+ */
+void qmdiHost::activateClient(qmdiClient *client) {
+    if (client == activeClient) {
+        return;
+    }
+
+    auto timer = QElapsedTimer();
+    if (statsEnabled) {
+        timer.start();
+    }
+
+    auto previous = activeClient;
+    auto overlaid = client && !mergedClients.contains(client);
+    activeClient = client;
+    menus.setOverlay(overlaid ? &client->menus : nullptr);
+    toolbars.setOverlay(overlaid ? &client->toolbars : nullptr);
+
+    if (previous && !mergedClients.contains(previous)) {
+        previous->on_client_unmerged(this);
+        detachActions(previous);
+    }
+    if (overlaid) {
+        client->on_client_merged(this);
+        attachActions(client);
+    }
+
+    if (statsEnabled) {
+        stats.activations++;
+        stats.activateNanoseconds += timer.nsecsElapsed();
+    }
+}
+
+/**
+ * \fn qmdiHost::getActiveClient()
+ * \brief returns the client displayed on top of the menus and toolbars
+ * \return the active client, or nullptr
+ * \since 0.1.1
+ *
+ * \see activateClient()
+ */
+
+/**
+ * \brief returns the actions of merged clients which use a shortcut
+ * \param shortcut the key sequence to look for
+ * \return the actions, in the order they were merged
+ * \since 0.1.1
+ *
+ * The host indexes the shortcuts of the actions in the menus and toolbars of
+ * merged clients (including the active client, see activateClient()). The
+ * index is updated on every merge and unmerge, looking up a shortcut does
+ * not depend on the number of actions. An action is indexed with the
+ * shortcuts it has when the first client containing it is merged. Shortcuts
+ * assigned to it later are not indexed until every client containing it has
+ * been un-merged and one is merged again.
+ *
+ * The actions of the menus and toolbars of the host itself are not indexed,
+ * and never lose their shortcuts to routing (see setShortcutRouting()).
+ *
+ * \see hasShortcutConflict()
+ */
+QList<QAction *> qmdiHost::getShortcutActions(const QKeySequence &shortcut) const {
+    auto actions = QList<QAction *>();
+    for (auto action : shortcutIndex.value(shortcut)) {
+        if (!actions.contains(action)) {
+            actions << action;
+        }
+    }
+    return actions;
+}
+
+/**
+ * \fn qmdiHost::hasShortcutConflict()
+ * \brief returns true if a shortcut is used by several actions of merged clients
+ * \param shortcut the key sequence to look for
+ * \since 0.1.1
+ *
+ * Qt considers such a shortcut ambiguous, and none of the actions is
+ * triggered, unless shortcut routing is enabled (see setShortcutRouting()).
+ *
+ * \see getShortcutConflicts()
+ */
+
+/**
+ * \fn qmdiHost::getShortcutConflicts()
+ * \brief returns the shortcuts used by several actions of merged clients
+ * \since 0.1.1
+ *
+ * \see getShortcutActions()
+ */
+
+/**
+ * \brief lets the host choose which action owns a conflicting shortcut
+ * \param enabled true to route conflicting shortcuts
+ * \since 0.1.1
+ *
+ * When several merged actions use the same shortcut, Qt reports an
+ * ambiguous shortcut and triggers none of them. With routing enabled, only
+ * the action merged last (usually, the action of the active client) keeps
+ * the shortcut, and the shortcut is removed from the other actions. Only one
+ * registration per shortcut reaches Qt. The shortcuts are given back when
+ * the conflict is resolved, when the actions are unmerged, or when routing
+ * is disabled. If the shortcuts of an action are modified by the
+ * application after they were routed, the host leaves them as they are.
+ *
+ * Routing is disabled by default.
+ *
+ * \see getShortcutConflicts()
+ */
+void qmdiHost::setShortcutRouting(bool enabled) {
+    if (shortcutRouting == enabled) {
+        return;
+    }
+    shortcutRouting = enabled;
+    for (auto &indexed : indexedShortcuts) {
+        routeShortcuts(indexed);
+    }
+}
+
+/**
+ * \fn qmdiHost::getShortcutRouting()
+ * \brief returns true if the host chooses which action owns a conflicting shortcut
+ * \since 0.1.1
+ *
+ * \see setShortcutRouting()
+ */
+
+/**
+ * \brief enables or disables the collection of statistics
+ * \param enabled true to start counting merges and updates
+ * \since 0.1.1
+ *
+ * Statistics are disabled by default. While disabled, the cost is a single
+ * branch per merge or update. When the library is built with
+ * QMDILIB_NO_STATS (the \b QMDILIB_STATS cmake option is off), this
+ * method does nothing, and the statistics are never collected.
+ *
+ * Enabling does not reset the counters, see resetStats().
+ *
+ * \see getStats()
+ * \see setStatsDumpInterval()
+ */
+void qmdiHost::setStatsEnabled(bool enabled) {
+#ifdef QMDILIB_NO_STATS
+    Q_UNUSED(enabled);
+#else
+    statsEnabled = enabled;
+    if (enabled && statsDumpInterval > 0 && !statsDumpTimer.isValid()) {
+        statsDumpTimer.start();
+    }
+#endif
+}
+
+/**
+ * \fn qmdiHost::getStatsEnabled()
+ * \brief returns true if statistics are being collected
+ * \since 0.1.1
+ *
+ * \see setStatsEnabled()
+ */
+
+/**
+ * \fn qmdiHost::getStats()
+ * \brief returns the statistics collected so far
+ * \since 0.1.1
+ *
+ * \see qmdiHostStats
+ * \see setStatsEnabled()
+ */
+
+/**
+ * \brief sets all the statistics counters to zero
+ * \since 0.1.1
+ *
+ * \see getStats()
+ */
+void qmdiHost::resetStats() { stats = qmdiHostStats(); }
+
+/**
+ * \brief periodically print the statistics to the debug output
+ * \param msec milliseconds between two dumps, or 0 to disable
+ * \since 0.1.1
+ *
+ * The statistics are printed from updateGUI(), at most once per \b msec
+ * milliseconds, and only while statistics are enabled. An idle host
+ * prints nothing.
+ *
+ * \see setStatsEnabled()
+ */
+void qmdiHost::setStatsDumpInterval(int msec) {
+    statsDumpInterval = msec;
+    statsDumpTimer.invalidate();
+    if (msec > 0) {
+        statsDumpTimer.start();
+    }
+}
+
+/**
+ * \fn qmdiHost::getStatsDumpInterval()
+ * \brief returns the milliseconds between two dumps of the statistics
+ * \since 0.1.1
+ *
+ * \see setStatsDumpInterval()
+ */
+
+/**
+ * \brief prints the statistics, if the dump interval has passed
+ *
+ * \internal
+ * \see setStatsDumpInterval()
+ */
+void qmdiHost::dumpStats() {
+    if (statsDumpInterval <= 0 || statsDumpTimer.elapsed() < statsDumpInterval) {
+        return;
+    }
+    statsDumpTimer.restart();
+    qDebug("qmdiHost stats: merges %llu, unmerges %llu, activations %llu, items moved %llu, "
+           "updateGUI %llu, menus rebuilt %llu, toolbars rebuilt %llu",
+           stats.merges, stats.unmerges, stats.activations, stats.itemsMoved,
+           stats.updateGUICalls, stats.menusRebuilt, stats.toolbarsRebuilt);
+    qDebug("qmdiHost stats: merge %lld ns, unmerge %lld ns, activate %lld ns, menus %lld ns, "
+           "toolbars %lld ns",
+           stats.mergeNanoseconds, stats.unmergeNanoseconds, stats.activateNanoseconds,
+           stats.menusNanoseconds, stats.toolbarsNanoseconds);
+}
+
+/**
+ * \brief counts the menu and toolbar entries of action group lists
+ * \param lists the lists to count
+ * \return the number of actions, separators and sub menus in all groups
+ *
+ * \internal
+ */
+qsizetype qmdiHost::itemCount(const QList<qmdiActionGroupList *> &lists) {
+    auto count = qsizetype(0);
+    for (auto const list : lists) {
+        for (auto const group : list->actionGroups) {
+            count += group->actionGroupItems.size();
+        }
+    }
+    return count;
+}
+
+/**
+ * \brief attaches the actions of a client to the host and client widgets
+ * \param client the client whose actions are attached
+ *
+ * The actions of the menus and toolbars of the client are added to the
+ * host, if it is a widget, and to the windows of the host, so their
+ * shortcuts work while the menus are hidden. They are also added to the client, if it is a widget.
+ *
+ * This is the only place where merging attaches actions, see
+ * addActionsToWidget(). The shortcuts of the actions are indexed here too.
+ *
+ * \internal
+ * \see detachActions()
+ */
+void qmdiHost::attachActions(qmdiClient *client) {
+    auto actions = clientActions(client);
+    indexShortcuts(actions);
+
+    auto widgets = hostWidgets();
+    if (auto clientWidget = dynamic_cast<QWidget *>(client)) {
+        widgets << clientWidget;
+    }
+    for (auto w : widgets) {
+        addActionsToWidget(actions, w);
+    }
+}
+
+/**
+ * \brief detaches the actions of a client from the host and client widgets
+ * \param client the client whose actions are detached
+ *
+ * \internal
+ * \see attachActions()
+ */
+void qmdiHost::detachActions(qmdiClient *client) {
+    auto actions = clientActions(client);
+    unindexShortcuts(actions);
+
+    auto widgets = hostWidgets();
+    if (auto clientWidget = dynamic_cast<QWidget *>(client)) {
+        widgets << clientWidget;
+    }
+    for (auto w : widgets) {
+        removeActionsFromWidget(actions, w);
+    }
+}
+
+/**
+ * \brief returns the widgets which hold the actions of merged clients
+ * \return \b this if it is a widget, followed by the windows of the host
+ *
+ * \internal
+ * \see addWindow()
+ */
+QList<QWidget *> qmdiHost::hostWidgets() {
+    auto widgets = QList<QWidget *>();
+    if (auto w = dynamic_cast<QWidget *>(this)) {
+        widgets << w;
+    }
+    for (auto &window : std::as_const(windows)) {
+        if (window && !widgets.contains(window)) {
+            widgets << window;
+        }
+    }
+    return widgets;
+}
+
+/**
+ * \brief returns the actions in the menus and toolbars of a client
+ * \param client the client to look for actions in
+ *
+ * Actions in sub menus and in QActionGroup items are included. An action
+ * is returned once for every place it is found in.
+ *
+ * \internal
+ */
+QList<QAction *> qmdiHost::clientActions(const qmdiClient *client) {
+    auto actions = QList<QAction *>();
+    for (auto list : {&client->menus, &client->toolbars}) {
+        for (auto group : list->actionGroups) {
+            collectActions(group, actions);
+        }
+    }
+    return actions;
+}
+
+/**
+ * \brief appends the actions of a group, and of its sub menus, to a list
+ * \param group the group to look for actions in
+ * \param actions the list to append to
+ *
+ * \internal
+ */
+void qmdiHost::collectActions(const qmdiActionGroup *group, QList<QAction *> &actions) {
+    for (auto subGroup : group->actionGroups) {
+        collectActions(subGroup, actions);
+    }
+    for (auto item : group->actionGroupItems) {
+        if (auto action = qobject_cast<QAction *>(item)) {
+            actions << action;
+        } else if (auto actionGroup = qobject_cast<QActionGroup *>(item)) {
+            actions << actionGroup->actions();
+        }
+    }
+}
+
+/**
+ * \brief add a list of actions to a widget
+ * \param actions the actions to add
+ * \param w the target widget
+ *
+ * Every call adds one reference to each action in \b w, and only actions
+ * which were not referenced yet are added to the widget, in a single call to
+ * QWidget::addActions(). An action shared by several clients is attached
+ * once, and stays attached until the last of them is removed by
+ * removeActionsFromWidget().
+ *
+ * Actions which were added to the widget by other means are never removed
+ * by the host.
+ *
+ * It's used internally by mergeClient()
+ *
+ * \see mergeClient
+ * \see QWidget::addActions
+ */
+void qmdiHost::addActionsToWidget(const QList<QAction *> &actions, QWidget *w) {
+    auto &attached = attachedActions[w];
+    if (attached.widget != w) {
+        // a new widget, maybe created where a deleted one used to be
+        attached.widget = w;
+        attached.references.clear();
+    }
+
+    auto current = w->actions();
+    auto existing = QSet<QAction *>(current.begin(), current.end());
+    auto missing = QList<QAction *>();
+    for (auto a : actions) {
+        auto reference = attached.references.find(a);
+        if (reference == attached.references.end() || !reference->action) {
+            // not ours if already in the widget, keep a reference which is never released
+            reference = attached.references.insert(a, {a, existing.contains(a) ? 1 : 0});
+        }
+        if (++reference->references == 1) {
+            missing << a;
+        }
+    }
+    if (updateDepth > 0) {
+        attached.dirty = true;
+        return;
+    }
+    if (!missing.isEmpty()) {
+        w->addActions(missing);
+    }
+}
+
+/**
+ * \brief remove a list of actions from a widget
+ * \param actions the actions to remove
+ * \param w the target widget
+ *
+ * Releases one reference to each action, and removes from \b w the actions
+ * which are no longer referenced.
+ *
+ * It's used internally by unmergeClient()
+ *
+ * \see unmergeClient
+ * \see QWidget::removeAction
+ */
+void qmdiHost::removeActionsFromWidget(const QList<QAction *> &actions, QWidget *w) {
+    auto attached = attachedActions.find(w);
+    if (attached == attachedActions.end()) {
+        return;
+    }
+    if (attached->widget != w) {
+        attachedActions.erase(attached);
+        return;
+    }
+
+    for (auto a : actions) {
+        auto reference = attached->references.find(a);
+        if (reference == attached->references.end()) {
+            continue;
+        }
+        if (!reference->action) {
+            attached->references.erase(reference);
+            continue;
+        }
+        if (--reference->references > 0) {
+            continue;
+        }
+        if (updateDepth > 0) {
+            // removed by syncAttachedActions()
+            attached->dirty = true;
+            continue;
+        }
+        attached->references.erase(reference);
+        w->removeAction(a);
+    }
+    if (attached->references.isEmpty()) {
+        attachedActions.erase(attached);
+    }
+}
+
+/**
+ * \brief attaches and detaches the actions modified during an update
+ *
+ * Between beginUpdate() and endUpdate() only the reference counts of the
+ * actions are modified. This makes each modified widget hold exactly the
+ * actions which are still referenced. The actions to remove are taken from
+ * the widget, so actions deleted in the meantime are not touched.
+ *
+ * \internal
+ * \see endUpdate()
+ */
+void qmdiHost::syncAttachedActions() {
+    for (auto it = attachedActions.begin(); it != attachedActions.end();) {
+        auto w = it->widget.data();
+        if (w == nullptr) {
+            it = attachedActions.erase(it);
+            continue;
+        }
+        if (!it->dirty) {
+            ++it;
+            continue;
+        }
+
+        it->dirty = false;
+        auto current = w->actions();
+        auto existing = QSet<QAction *>(current.begin(), current.end());
+        auto missing = QList<QAction *>();
+        for (auto reference = it->references.begin(); reference != it->references.end();) {
+            auto a = reference->action.data();
+            if (a == nullptr) {
+                reference = it->references.erase(reference);
+                continue;
+            }
+            if (reference->references > 0) {
+                if (!existing.contains(a)) {
+                    missing << a;
+                }
+                ++reference;
+                continue;
+            }
+            if (existing.contains(a)) {
+                w->removeAction(a);
+            }
+            reference = it->references.erase(reference);
+        }
+        if (!missing.isEmpty()) {
+            w->addActions(missing);
+        }
+
+        if (it->references.isEmpty()) {
+            it = attachedActions.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+/**
+ * \brief adds the shortcuts of actions to the shortcut index
+ * \param actions the actions of a client being merged
+ *
+ * \internal
+ * \see unindexShortcuts()
+ */
+void qmdiHost::indexShortcuts(const QList<QAction *> &actions) {
+    auto modified = QSet<QKeySequence>();
+    for (auto a : actions) {
+        auto indexed = indexedShortcuts.find(a);
+        if (indexed != indexedShortcuts.end() && !indexed->action) {
+            // a deleted action, and a new one allocated at the same address
+            for (auto &shortcut : std::as_const(indexed->shortcuts)) {
+                shortcutIndex[shortcut].removeAll(a);
+                if (shortcutIndex[shortcut].isEmpty()) {
+                    shortcutIndex.remove(shortcut);
+                }
+                modified.insert(shortcut);
+            }
+            indexedShortcuts.erase(indexed);
+            indexed = indexedShortcuts.end();
+        }
+        if (indexed == indexedShortcuts.end()) {
+            auto shortcuts = a->shortcuts();
+            if (shortcuts.isEmpty()) {
+                continue;
+            }
+            indexed = indexedShortcuts.insert(a, {a, shortcuts, 0, false, {}});
+        }
+        indexed->references++;
+        for (auto &shortcut : std::as_const(indexed->shortcuts)) {
+            shortcutIndex[shortcut] << a;
+            modified.insert(shortcut);
+        }
+    }
+    updateShortcuts(modified);
+}
+
+/**
+ * \brief removes the shortcuts of actions from the shortcut index
+ * \param actions the actions of a client being un-merged
+ *
+ * Actions which are no longer referenced get back the shortcuts removed by
+ * routing, unless their shortcuts were modified since.
+ *
+ * \internal
+ * \see indexShortcuts()
+ */
+void qmdiHost::unindexShortcuts(const QList<QAction *> &actions) {
+    auto modified = QSet<QKeySequence>();
+    for (auto a : actions) {
+        auto indexed = indexedShortcuts.find(a);
+        if (indexed == indexedShortcuts.end()) {
+            continue;
+        }
+        for (auto &shortcut : std::as_const(indexed->shortcuts)) {
+            auto index = shortcutIndex.find(shortcut);
+            if (index == shortcutIndex.end()) {
+                continue;
+            }
+            index->removeOne(a);
+            if (index->isEmpty()) {
+                shortcutIndex.erase(index);
+            }
+            modified.insert(shortcut);
+        }
+        if (--indexed->references > 0) {
+            continue;
+        }
+        if (indexed->routed && indexed->action &&
+            indexed->action->shortcuts() == indexed->routedShortcuts) {
+            indexed->action->setShortcuts(indexed->shortcuts);
+        }
+        indexedShortcuts.erase(indexed);
+    }
+    updateShortcuts(modified);
+}
+
+/**
+ * \brief updates the conflicts and the routing of modified shortcuts
+ * \param shortcuts the shortcuts whose actions have been modified
+ *
+ * \internal
+ */
+void qmdiHost::updateShortcuts(const QSet<QKeySequence> &shortcuts) {
+    for (auto &shortcut : shortcuts) {
+        auto actions = shortcutIndex.value(shortcut);
+        auto conflict = false;
+        for (auto a : actions) {
+            if (a != actions.first()) {
+                conflict = true;
+                break;
+            }
+        }
+        if (conflict) {
+            conflictingShortcuts.insert(shortcut);
+        } else {
+            conflictingShortcuts.remove(shortcut);
+        }
+    }
+
+    if (!shortcutRouting) {
+        return;
+    }
+    auto routed = QSet<const QAction *>();
+    for (auto &shortcut : shortcuts) {
+        for (auto a : shortcutIndex.value(shortcut)) {
+            if (routed.contains(a)) {
+                continue;
+            }
+            routed.insert(a);
+            routeShortcuts(indexedShortcuts[a]);
+        }
+    }
+}
+
+/**
+ * \brief sets the shortcuts of an action, according to the routing
+ * \param indexed the indexed action
+ *
+ * With routing, an action keeps a conflicting shortcut only if it is the
+ * last action merged with it. Without routing, the action gets back the
+ * shortcuts it had when indexed.
+ *
+ * The shortcuts of the action are modified only if they are still the ones
+ * the host expects: the indexed shortcuts, or the routed ones. Shortcuts set
+ * by the application are never overwritten.
+ *
+ * \internal
+ * \see setShortcutRouting()
+ */
+void qmdiHost::routeShortcuts(IndexedShortcuts &indexed) {
+    if (!indexed.action) {
+        return;
+    }
+    auto current = indexed.action->shortcuts();
+    if (current != (indexed.routed ? indexed.routedShortcuts : indexed.shortcuts)) {
+        indexed.routed = false;
+        return;
+    }
+
+    auto shortcuts = QList<QKeySequence>();
+    for (auto &shortcut : std::as_const(indexed.shortcuts)) {
+        if (shortcutRouting && conflictingShortcuts.contains(shortcut) &&
+            shortcutIndex.value(shortcut).constLast() != indexed.action) {
+            continue;
+        }
+        shortcuts << shortcut;
+    }
+    indexed.routed = shortcuts != indexed.shortcuts;
+    indexed.routedShortcuts = indexed.routed ? shortcuts : QList<QKeySequence>();
+    if (current != shortcuts) {
+        indexed.action->setShortcuts(shortcuts);
+    }
 }
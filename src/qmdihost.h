@@ -11,12 +11,35 @@
 // the reason for including this file, and not declare the classes
 // is for the developer using this library - one single include
 
+#include <QElapsedTimer>
+#include <QKeySequence>
+#include <QPointer>
+#include <QSet>
+
 #include "qmdiactiongroup.h"
+#include "qmdiactiongrouplayout.h"
 #include "qmdiactiongrouplist.h"
+#include "qmdirenderer.h"
 
 class QMainWindow;
+class QTimer;
 class qmdiClient;
 
+struct qmdiHostStats {
+    quint64 merges = 0;
+    quint64 unmerges = 0;
+    quint64 activations = 0;
+    quint64 itemsMoved = 0;
+    quint64 updateGUICalls = 0;
+    quint64 menusRebuilt = 0;
+    quint64 toolbarsRebuilt = 0;
+    qint64 mergeNanoseconds = 0;
+    qint64 unmergeNanoseconds = 0;
+    qint64 activateNanoseconds = 0;
+    qint64 menusNanoseconds = 0;
+    qint64 toolbarsNanoseconds = 0;
+};
+
 class qmdiHost {
   public:
     qmdiHost();
@@ -26,12 +49,119 @@ class qmdiHost {
     qmdiActionGroupList toolbars;
 
     virtual void updateGUI(QMainWindow *window = nullptr);
+    void flushGUI();
+    void addWindow(QMainWindow *window);
+    void removeWindow(QMainWindow *window);
+    QList<QMainWindow *> getWindows();
+    void addRenderer(qmdiRenderer *renderer);
+    void removeRenderer(qmdiRenderer *renderer);
+    QList<qmdiRenderer *> getRenderers() const { return renderers; }
+    void setDeferredUpdates(bool deferred);
+    bool getDeferredUpdates() const { return deferredUpdates; }
+    void beginUpdate();
+    void endUpdate();
+    bool isUpdating() const { return updateDepth > 0; }
     void mergeClient(qmdiClient *client);
     void unmergeClient(qmdiClient *client);
+    void mergeClients(const QList<qmdiClient *> &clients);
+    void unmergeClients(const QList<qmdiClient *> &clients);
+    void activateClient(qmdiClient *client);
+    qmdiClient *getActiveClient() const { return activeClient; }
     virtual void onClientClosed(qmdiClient *client) { Q_UNUSED(client); }
 
+    QList<QAction *> getShortcutActions(const QKeySequence &shortcut) const;
+    bool hasShortcutConflict(const QKeySequence &shortcut) const {
+        return conflictingShortcuts.contains(shortcut);
+    }
+    QList<QKeySequence> getShortcutConflicts() const { return conflictingShortcuts.values(); }
+    void setShortcutRouting(bool enabled);
+    bool getShortcutRouting() const { return shortcutRouting; }
+
+    void setStatsEnabled(bool enabled);
+    bool getStatsEnabled() const { return statsEnabled; }
+    const qmdiHostStats &getStats() const { return stats; }
+    void resetStats();
+    void setStatsDumpInterval(int msec);
+    int getStatsDumpInterval() const { return statsDumpInterval; }
+
   protected:
-    QList<QToolBar *> *toolBarList;
-    void addActionsToWidget(const qmdiActionGroupList &agl, QWidget *w);
-    void removeActionsFromWidget(const qmdiActionGroupList &agl, QWidget *w);
+    struct RenderedWindow {
+        QPointer<QMainWindow> window;
+        quint64 menusGeneration = 0;
+        quint64 toolbarsGeneration = 0;
+    };
+    QHash<const QMainWindow *, RenderedWindow> renderedWindows;
+    QList<QPointer<QMainWindow>> windows;
+    struct RenderedGenerations {
+        quint64 menusGeneration = 0;
+        quint64 toolbarsGeneration = 0;
+    };
+    QList<qmdiRenderer *> renderers;
+    QHash<const qmdiRenderer *, RenderedGenerations> renderedRenderers;
+    bool renderersPending = false;
+    qmdiClient *activeClient = nullptr;
+    QSet<const qmdiClient *> mergedClients;
+    bool deferredUpdates = false;
+    QTimer *updateTimer = nullptr;
+    QList<QPointer<QMainWindow>> pendingWindows;
+    int updateDepth = 0;
+
+    struct AttachedAction {
+        QPointer<QAction> action;
+        int references = 0;
+    };
+    struct AttachedActions {
+        QPointer<QWidget> widget;
+        QHash<const QAction *, AttachedAction> references;
+        bool dirty = false;
+    };
+    QHash<const QWidget *, AttachedActions> attachedActions;
+
+    struct IndexedShortcuts {
+        QPointer<QAction> action;
+        QList<QKeySequence> shortcuts;
+        int references = 0;
+        bool routed = false;
+        QList<QKeySequence> routedShortcuts;
+    };
+    QHash<const QAction *, IndexedShortcuts> indexedShortcuts;
+    QHash<QKeySequence, QList<QAction *>> shortcutIndex;
+    QSet<QKeySequence> conflictingShortcuts;
+    bool shortcutRouting = false;
+#ifdef QMDILIB_NO_STATS
+    static constexpr bool statsEnabled = false;
+#else
+    bool statsEnabled = false;
+#endif
+    qmdiHostStats stats;
+    int statsDumpInterval = 0;
+    QElapsedTimer statsDumpTimer;
+    void dumpStats();
+    static qsizetype itemCount(const QList<qmdiActionGroupList *> &lists);
+    void renderGUI(QMainWindow *window);
+    void renderGUI(qmdiRenderer *renderer);
+    void renderPendingGUI();
+    void scheduleGUI();
+    QList<QWidget *> hostWidgets();
+    void attachActions(qmdiClient *client);
+    void detachActions(qmdiClient *client);
+    void addActionsToWidget(const QList<QAction *> &actions, QWidget *w);
+    void removeActionsFromWidget(const QList<QAction *> &actions, QWidget *w);
+    static QList<QAction *> clientActions(const qmdiClient *client);
+    static void collectActions(const qmdiActionGroup *group, QList<QAction *> &actions);
+    void syncAttachedActions();
+    void indexShortcuts(const QList<QAction *> &actions);
+    void unindexShortcuts(const QList<QAction *> &actions);
+    void updateShortcuts(const QSet<QKeySequence> &shortcuts);
+    void routeShortcuts(IndexedShortcuts &indexed);
+};
+
+class qmdiUpdateGuard {
+  public:
+    explicit qmdiUpdateGuard(qmdiHost *host) : host(host) { host->beginUpdate(); }
+    ~qmdiUpdateGuard() { host->endUpdate(); }
+
+  private:
+    Q_DISABLE_COPY(qmdiUpdateGuard)
+    qmdiHost *host;
 };
@@ -0,0 +1,95 @@
+/**
+ * \file qmdirenderer.cpp
+ * \brief Implementation of the renderer classes
+ * \author Diego Iastrubni (diegoiast@gmail.com)
+ * License LGPL 2 or 3
+ * \see qmdiRenderer
+ */
+
+#include "qmdirenderer.h"
+
+/**
+ * \class qmdiRenderer
+ * \brief displays the menus and toolbars of a qmdiHost
+ * \since 0.1.1
+ *
+ * The menus and toolbars of a host are a model: groups of actions, merged
+ * from the clients, with their merge points, breaks and generations. The
+ * model does not create widgets. The windows of the host (see
+ * qmdiHost::addWindow()) display it using QMenuBar and QToolBar. A renderer
+ * is another target for displaying the model, added with
+ * qmdiHost::addRenderer().
+ *
+ * qmdiHost::updateGUI() calls a renderer only when the menus or toolbars
+ * have been modified since the last time they were passed to it, exactly as
+ * it does for windows. The host keeps track of what each renderer displays.
+ *
+ * \see qmdiNullRenderer
+ */
+
+/**
+ * \brief destructor
+ *
+ * Remove the renderer from its host (see qmdiHost::removeRenderer()) before
+ * destroying it.
+ */
+qmdiRenderer::~qmdiRenderer() {}
+
+/**
+ * \fn qmdiRenderer::updateMenus()
+ * \brief display the menus of the host
+ * \param menus the menus of the host, with the merged clients
+ */
+
+/**
+ * \fn qmdiRenderer::updateToolBars()
+ * \brief display the toolbars of the host
+ * \param toolbars the toolbars of the host, with the merged clients
+ */
+
+/**
+ * \class qmdiNullRenderer
+ * \brief a renderer which displays nothing
+ * \since 0.1.1
+ *
+ * This renderer only counts the updates it gets. Use it to run a qmdiHost
+ * without any window, for example in tests and benchmarks of merging, where
+ * no display is available or where the cost of widgets should not be
+ * measured.
+ *
+ * \code
+ * auto host = qmdiHost();
+ * auto renderer = qmdiNullRenderer();
+ * host.addRenderer(&renderer);
+ * host.mergeClient(&client);
+ * host.updateGUI();
+ * \endcode
+ */
+
+/**
+ * \brief counts an update of the menus
+ * \param menus the menus of the host, not used
+ */
+void qmdiNullRenderer::updateMenus(qmdiActionGroupList &menus) {
+    Q_UNUSED(menus);
+    menusUpdates++;
+}
+
+/**
+ * \brief counts an update of the toolbars
+ * \param toolbars the toolbars of the host, not used
+ */
+void qmdiNullRenderer::updateToolBars(qmdiActionGroupList &toolbars) {
+    Q_UNUSED(toolbars);
+    toolBarsUpdates++;
+}
+
+/**
+ * \fn qmdiNullRenderer::getMenusUpdates()
+ * \brief returns the number of times the menus were updated
+ */
+
+/**
+ * \fn qmdiNullRenderer::getToolBarsUpdates()
+ * \brief returns the number of times the toolbars were updated
+ */
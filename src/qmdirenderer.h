@@ -0,0 +1,34 @@
+#pragma once
+
+/**
+ * \file qmdirenderer.h
+ * \brief Definition of the renderer classes
+ * \author Diego Iastrubni (diegoiast@gmail.com)
+ * License LGPL 2 or 3
+ * \see qmdiRenderer
+ */
+
+#include <QtGlobal>
+
+class qmdiActionGroupList;
+
+class qmdiRenderer {
+  public:
+    virtual ~qmdiRenderer();
+
+    virtual void updateMenus(qmdiActionGroupList &menus) = 0;
+    virtual void updateToolBars(qmdiActionGroupList &toolbars) = 0;
+};
+
+class qmdiNullRenderer : public qmdiRenderer {
+  public:
+    void updateMenus(qmdiActionGroupList &menus) override;
+    void updateToolBars(qmdiActionGroupList &toolbars) override;
+
+    int getMenusUpdates() const { return menusUpdates; }
+    int getToolBarsUpdates() const { return toolBarsUpdates; }
+
+  private:
+    int menusUpdates = 0;
+    int toolBarsUpdates = 0;
+};
@@ -124,20 +124,11 @@ void qmdiTabWidget::tabChanged(int i) {
     if (w == activeWidget) {
         return;
     }
-    auto client = dynamic_cast<qmdiClient *>(activeWidget);
-    if (client) {
-        mdiHost->unmergeClient(client);
-    }
-
     activeWidget = w;
 
-    client = dynamic_cast<qmdiClient *>(activeWidget);
-    if (activeWidget) {
-        mdiHost->mergeClient(client);
-    }
-
-    auto m = dynamic_cast<QMainWindow *>(mdiHost);
-    mdiHost->updateGUI(m);
+    auto client = dynamic_cast<qmdiClient *>(activeWidget);
+    mdiHost->activateClient(client);
+    mdiHost->updateGUI();
     mdiSelected(client, i);
 }
 
@@ -321,7 +312,9 @@ int qmdiTabWidget::getClientsCount() const { return count(); }
  * or by deleting the object, this function will be called.
  *
  * This function removes the menus and toolbars of the widget (if it is the
- * active widget) and sets the active widget to nullptr. When a new tab will be
+ * active widget) and sets the active widget to nullptr. For other widgets,
+ * the menus and toolbars the host computed for them are released (see
+ * qmdiHost::unmergeClient()). When a new tab will be
  * selected, which will happen if there is another widget on the tab widget, the
  * new client will be merged.
  *
@@ -336,12 +329,14 @@ void qmdiTabWidget::deleteClient(qmdiClient *client) {
         return;
     }
 
+    // clients in the background are not displayed, but the host still keeps
+    // the menus and toolbars computed when they were active
+    mdiHost->unmergeClient(client);
     if (dynamic_cast<qmdiClient *>(activeWidget) != client) {
         return;
     }
 
-    mdiHost->unmergeClient(client);
-    mdiHost->updateGUI(dynamic_cast<QMainWindow *>(mdiHost));
+    mdiHost->updateGUI();
     activeWidget = nullptr;
 }
 
@@ -396,7 +391,7 @@ void qmdiTabWidget::tabRemoved(int index) {
         activeWidget = nullptr;
 
         // the deletion of menus and toolbars is made by qmdiClient itself
-        mdiHost->updateGUI(dynamic_cast<QMainWindow *>(mdiHost));
+        mdiHost->updateGUI();
     }
     Q_UNUSED(index);
 }
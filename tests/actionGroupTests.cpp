@@ -0,0 +1,696 @@
+#include <qmdiactiongroup.h>
+#include <qmdiactiongrouplayout.h>
+
+#include <QAction>
+#include <QMainWindow>
+#include <QKeySequence>
+#include <QMenu>
+#include <QMenuBar>
+#include <QToolBar>
+#include <QtTest>
+
+#include "testHelpers.h"
+
+class TestQmdiActionGroup : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void addAndContains();
+    void addAtLocation();
+    void removeKeepsOrder();
+    void readdMovesAction();
+    void mergeAtMergePoint();
+    void mergePointFollowsChanges();
+    void unmergeRestoresOrder();
+    void mergeOrderedByPriority();
+    void unmergeKeepsOwnItems();
+    void findActionNamed();
+    void mergeGroupsMatchesMergeGroup();
+    void mergeGroupsFollowsMergePoints();
+    void updateMenuIncremental();
+    void updateToolBarIncremental();
+    void lazyMenuPopulatedOnShow();
+    void separatorsAreShared();
+    void mergedSeparatorsAreCopied();
+    void overlayMatchesMerge();
+    void overlayShowsWidgets();
+    void overlayKeepsListGroups();
+    void layoutCreatesGroups();
+    void listFindsGroupsByName();
+    void menuBarReusesMenus();
+    void toolBarsFollowGroups();
+    void toolBarsAreRenamed();
+    void popMenuReusesSubMenus();
+    void namesAreInterned();
+};
+
+void TestQmdiActionGroup::addAndContains() {
+    auto group = qmdiActionGroup("test");
+    auto actions = makeActions(3, this);
+    auto other = QAction("other");
+
+    QVERIFY(group.empty());
+    for (auto a : actions) {
+        group.addAction(a);
+    }
+    QVERIFY(!group.empty());
+    for (auto a : actions) {
+        QVERIFY(group.containsAction(a));
+    }
+    QVERIFY(!group.containsAction(&other));
+}
+
+void TestQmdiActionGroup::addAtLocation() {
+    auto group = qmdiActionGroup("test");
+    auto actions = makeActions(3, this);
+
+    group.addAction(actions[0]);
+    group.addAction(actions[1]);
+    group.addAction(actions[2], 1);
+
+    auto menu = group.updateMenu();
+    QCOMPARE(menu->actions(), QList<QAction *>({actions[0], actions[2], actions[1]}));
+    delete menu;
+}
+
+void TestQmdiActionGroup::removeKeepsOrder() {
+    auto group = qmdiActionGroup("test");
+    auto actions = makeActions(4, this);
+    for (auto a : actions) {
+        group.addAction(a);
+    }
+
+    group.removeAction(actions[1]);
+    QVERIFY(!group.containsAction(actions[1]));
+    QVERIFY(group.containsAction(actions[2]));
+
+    // the index must still be valid after the removal
+    group.removeAction(actions[3]);
+    QVERIFY(!group.containsAction(actions[3]));
+
+    auto menu = group.updateMenu();
+    QCOMPARE(menu->actions(), QList<QAction *>({actions[0], actions[2]}));
+    delete menu;
+}
+
+void TestQmdiActionGroup::readdMovesAction() {
+    auto group = qmdiActionGroup("test");
+    auto actions = makeActions(3, this);
+    for (auto a : actions) {
+        group.addAction(a);
+    }
+
+    group.addAction(actions[0]);
+
+    auto menu = group.updateMenu();
+    QCOMPARE(menu->actions(), QList<QAction *>({actions[1], actions[2], actions[0]}));
+    delete menu;
+}
+
+void TestQmdiActionGroup::mergeAtMergePoint() {
+    auto host = qmdiActionGroup("host");
+    auto client = qmdiActionGroup("client");
+    auto hostActions = makeActions(2, this);
+    auto clientActions = makeActions(2, this);
+
+    host.addAction(hostActions[0]);
+    host.setMergePoint();
+    host.addAction(hostActions[1]);
+    for (auto a : clientActions) {
+        client.addAction(a);
+    }
+
+    host.mergeGroup(&client);
+    for (auto a : clientActions) {
+        QVERIFY(host.containsAction(a));
+    }
+
+    auto menu = host.updateMenu();
+    QCOMPARE(menu->actions(), QList<QAction *>({hostActions[0], clientActions[0],
+                                                clientActions[1], hostActions[1]}));
+    delete menu;
+}
+
+void TestQmdiActionGroup::mergePointFollowsChanges() {
+    auto host = qmdiActionGroup("host");
+    auto client1 = qmdiActionGroup("client1");
+    auto client2 = qmdiActionGroup("client2");
+    auto hostActions = makeActions(3, this);
+    auto clientActions = makeActions(5, this);
+
+    host.addAction(hostActions[0]);
+    host.setMergePoint();
+    host.addAction(hostActions[1]);
+    client1.addAction(clientActions[0]);
+    client1.addAction(clientActions[1]);
+    client1.setMergePoint();
+    client2.addAction(clientActions[2]);
+    client2.addAction(clientActions[3]);
+    client2.addAction(clientActions[4]);
+    client2.setMergePoint();
+    QCOMPARE(host.getMergePoint(), 1);
+
+    host.mergeGroups({&client1, &client2});
+    QCOMPARE(host.getMergePoint(), 3);
+    host.unmergeGroup(&client1);
+    QCOMPARE(host.getMergePoint(), 3);
+    host.removeAction(hostActions[1]);
+    QCOMPARE(host.getMergePoint(), 3);
+    host.unmergeGroup(&client2);
+    QCOMPARE(host.getMergePoint(), 1);
+
+    host.addAction(hostActions[2]);
+    host.setMergePoint();
+    QCOMPARE(host.getMergePoint(), 2);
+    host.mergeGroup(&client2);
+    QCOMPARE(host.getMergePoint(), 3);
+    host.unmergeGroup(&client2);
+    QCOMPARE(host.getMergePoint(), 2);
+
+    host.mergeGroup(&client1);
+    auto menu = host.updateMenu();
+    QCOMPARE(menu->actions(), QList<QAction *>({hostActions[0], hostActions[2], clientActions[0],
+                                                clientActions[1]}));
+    delete menu;
+}
+
+void TestQmdiActionGroup::unmergeRestoresOrder() {
+    auto host = qmdiActionGroup("host");
+    auto client = qmdiActionGroup("client");
+    auto hostActions = makeActions(2, this);
+    auto clientActions = makeActions(3, this);
+
+    host.addAction(hostActions[0]);
+    host.setMergePoint();
+    host.addAction(hostActions[1]);
+    for (auto a : clientActions) {
+        client.addAction(a);
+    }
+
+    host.mergeGroup(&client);
+    host.unmergeGroup(&client);
+    for (auto a : clientActions) {
+        QVERIFY(!host.containsAction(a));
+    }
+
+    auto menu = host.updateMenu();
+    QCOMPARE(menu->actions(), QList<QAction *>({hostActions[0], hostActions[1]}));
+    delete menu;
+}
+
+void TestQmdiActionGroup::mergeOrderedByPriority() {
+    auto host = qmdiActionGroup("host");
+    auto low = qmdiActionGroup("low");
+    auto high1 = qmdiActionGroup("high1");
+    auto high2 = qmdiActionGroup("high2");
+    auto hostActions = makeActions(2, this);
+    auto lowAction = QAction("low");
+    auto high1Action = QAction("high1");
+    auto high2Action = QAction("high2");
+
+    host.addAction(hostActions[0]);
+    host.setMergePoint();
+    host.addAction(hostActions[1]);
+    low.addAction(&lowAction);
+    high1.addAction(&high1Action);
+    high2.addAction(&high2Action);
+    high1.setMergePriority(10);
+    high2.setMergePriority(10);
+
+    host.mergeGroup(&high1);
+    host.mergeGroup(&low);
+    host.mergeGroup(&high2);
+
+    auto menu = host.updateMenu();
+    QCOMPARE(menu->actions(), QList<QAction *>({hostActions[0], &lowAction, &high1Action,
+                                                &high2Action, hostActions[1]}));
+
+    // re-merging moves the group after the groups of the same priority
+    host.unmergeGroup(&high1);
+    host.mergeGroup(&high1);
+    host.updateMenu(menu);
+    QCOMPARE(menu->actions(), QList<QAction *>({hostActions[0], &lowAction, &high2Action,
+                                                &high1Action, hostActions[1]}));
+    delete menu;
+}
+
+void TestQmdiActionGroup::unmergeKeepsOwnItems() {
+    auto host = qmdiActionGroup("host");
+    auto client = qmdiActionGroup("client");
+    auto actions = makeActions(3, this);
+
+    host.addAction(actions[0]);
+    host.addAction(actions[1]);
+    client.addAction(actions[1]);
+    client.addAction(actions[2]);
+
+    host.mergeGroup(&client);
+    host.unmergeGroup(&client);
+
+    auto menu = host.updateMenu();
+    QCOMPARE(menu->actions(), QList<QAction *>({actions[0], actions[1]}));
+    delete menu;
+}
+
+void TestQmdiActionGroup::findActionNamed() {
+    auto host = qmdiActionGroup("host");
+    auto client = qmdiActionGroup("client");
+    auto nested = qmdiActionGroup("nested");
+    auto actions = makeActions(3, this);
+    actions[0]->setObjectName("first");
+    actions[1]->setObjectName("second");
+    actions[2]->setObjectName("third");
+
+    host.addAction(actions[0]);
+    client.addAction(actions[1]);
+    nested.addAction(actions[2]);
+    client.mergeGroup(&nested);
+    host.mergeGroup(&client);
+
+    QCOMPARE(host.findActionNamed("first"), actions[0]);
+    QCOMPARE(host.findActionNamed("second"), actions[1]);
+    QCOMPARE(host.findActionNamed("third"), actions[2]);
+    QCOMPARE(host.findActionNamed("fourth"), nullptr);
+
+    actions[2]->setObjectName("fourth");
+    QCOMPARE(host.findActionNamed("third"), nullptr);
+    QCOMPARE(host.findActionNamed("fourth"), actions[2]);
+
+    host.unmergeGroup(&client);
+    QCOMPARE(host.findActionNamed("second"), nullptr);
+}
+
+void TestQmdiActionGroup::mergeGroupsMatchesMergeGroup() {
+    auto hostActions = makeActions(2, this);
+    auto sequential = qmdiActionGroup("sequential");
+    auto batch = qmdiActionGroup("batch");
+    for (auto host : {&sequential, &batch}) {
+        host->addAction(hostActions[0]);
+        host->setMergePoint();
+        host->addAction(hostActions[1]);
+    }
+
+    auto clients = QList<qmdiActionGroup *>();
+    for (auto i = 0; i < 4; i++) {
+        auto client = new qmdiActionGroup(QString("client %1").arg(i));
+        client->setMergePriority(i % 2 ? 10 : 0);
+        for (auto a : makeActions(3, this)) {
+            client->addAction(a);
+        }
+        clients << client;
+    }
+
+    sequential.mergeGroup(clients[0]);
+    sequential.mergeGroup(clients[1]);
+    sequential.mergeGroup(clients[2]);
+    sequential.mergeGroup(clients[3]);
+    batch.mergeGroup(clients[0]);
+    batch.mergeGroups({clients[1], clients[2], clients[3]});
+
+    auto sequentialMenu = sequential.updateMenu();
+    auto batchMenu = batch.updateMenu();
+    QCOMPARE(batchMenu->actions(), sequentialMenu->actions());
+
+    sequential.unmergeGroup(clients[1]);
+    sequential.unmergeGroup(clients[2]);
+    batch.unmergeGroups({clients[1], clients[2]});
+    sequential.updateMenu(sequentialMenu);
+    batch.updateMenu(batchMenu);
+    QCOMPARE(batchMenu->actions(), sequentialMenu->actions());
+
+    delete sequentialMenu;
+    delete batchMenu;
+    qDeleteAll(clients);
+}
+
+void TestQmdiActionGroup::mergeGroupsFollowsMergePoints() {
+    auto hostActions = makeActions(3, this);
+    auto clientActions = makeActions(1, this);
+    auto sequential = qmdiActionGroup("sequential");
+    auto batch = qmdiActionGroup("batch");
+    for (auto host : {&sequential, &batch}) {
+        host->addAction(hostActions[0]);
+        host->setMergePoint();
+        host->addAction(hostActions[1]);
+        host->addAction(hostActions[2]);
+    }
+
+    // the first client adds no items, only moves the merge point to the end
+    auto client1 = qmdiActionGroup("client1");
+    for (auto a : hostActions) {
+        client1.addAction(a);
+    }
+    client1.setMergePoint();
+    auto client2 = qmdiActionGroup("client2");
+    client2.addAction(clientActions[0]);
+
+    sequential.mergeGroup(&client1);
+    sequential.mergeGroup(&client2);
+    batch.mergeGroups({&client1, &client2});
+
+    auto sequentialMenu = sequential.updateMenu();
+    auto batchMenu = batch.updateMenu();
+    QCOMPARE(sequentialMenu->actions(), QList<QAction *>({hostActions[0], hostActions[1],
+                                                          hostActions[2], clientActions[0]}));
+    QCOMPARE(batchMenu->actions(), sequentialMenu->actions());
+    delete sequentialMenu;
+    delete batchMenu;
+}
+
+void TestQmdiActionGroup::updateMenuIncremental() {
+    auto group = qmdiActionGroup("test");
+    auto actions = makeActions(4, this);
+    group.addAction(actions[0]);
+    group.addAction(actions[1]);
+    group.addAction(actions[2]);
+
+    auto menu = group.updateMenu();
+    QCOMPARE(menu->actions(), QList<QAction *>({actions[0], actions[1], actions[2]}));
+
+    group.removeAction(actions[1]);
+    group.addAction(actions[3], 0);
+    group.addAction(actions[0]);
+    QCOMPARE(group.updateMenu(menu), menu);
+    QCOMPARE(menu->actions(), QList<QAction *>({actions[3], actions[2], actions[0]}));
+
+    // nothing changed, nothing should move
+    QCOMPARE(group.updateMenu(menu), menu);
+    QCOMPARE(menu->actions(), QList<QAction *>({actions[3], actions[2], actions[0]}));
+    delete menu;
+}
+
+void TestQmdiActionGroup::updateToolBarIncremental() {
+    auto group = qmdiActionGroup("test");
+    auto actions = makeActions(3, this);
+    auto toolbar = QToolBar();
+    group.addAction(actions[0]);
+    group.addAction(actions[1]);
+
+    group.updateToolBar(&toolbar);
+    QCOMPARE(toolbar.windowTitle(), QString("test"));
+    QCOMPARE(toolbar.actions(), QList<QAction *>({actions[0], actions[1]}));
+
+    group.addAction(actions[2], 1);
+    group.updateToolBar(&toolbar);
+    QCOMPARE(toolbar.actions(), QList<QAction *>({actions[0], actions[2], actions[1]}));
+
+    group.removeAction(actions[0]);
+    group.removeAction(actions[1]);
+    group.removeAction(actions[2]);
+    group.updateToolBar(&toolbar);
+    QVERIFY(toolbar.actions().isEmpty());
+    QVERIFY(toolbar.isHidden());
+}
+
+void TestQmdiActionGroup::lazyMenuPopulatedOnShow() {
+    auto group = qmdiActionGroup("test");
+    auto actions = makeActions(4, this);
+    actions[1]->setShortcut(QKeySequence("Ctrl+K"));
+    group.addAction(actions[0]);
+    group.addAction(actions[1]);
+    group.addAction(actions[2]);
+
+    // only actions with shortcuts are available before the menu is shown
+    auto menu = group.updateLazyMenu();
+    QCOMPARE(menu->actions(), QList<QAction *>({actions[1]}));
+
+    emit menu->aboutToShow();
+    QCOMPARE(menu->actions(), QList<QAction *>({actions[0], actions[1], actions[2]}));
+
+    // populated menus are not touched until the group changes
+    QCOMPARE(group.updateLazyMenu(menu), menu);
+    QCOMPARE(menu->actions(), QList<QAction *>({actions[0], actions[1], actions[2]}));
+
+    group.addAction(actions[3]);
+    group.updateLazyMenu(menu);
+    QCOMPARE(menu->actions(), QList<QAction *>({actions[1]}));
+    emit menu->aboutToShow();
+    QCOMPARE(menu->actions(),
+             QList<QAction *>({actions[0], actions[1], actions[2], actions[3]}));
+    delete menu;
+}
+
+void TestQmdiActionGroup::separatorsAreShared() {
+    auto host = qmdiActionGroup("host");
+    auto client = qmdiActionGroup("client");
+    auto actions = makeActions(3, this);
+
+    host.addAction(actions[0]);
+    host.addSeparator();
+    host.addAction(actions[1]);
+    client.addSeparator();
+    client.addAction(actions[2]);
+    host.mergeGroup(&client);
+
+    auto hostMenu = host.updateMenu();
+    auto clientMenu = client.updateMenu();
+    auto hostItems = hostMenu->actions();
+    QCOMPARE(hostItems.size(), 5);
+    QVERIFY(hostItems[1]->isSeparator());
+    QVERIFY(hostItems[3]->isSeparator());
+    QVERIFY(hostItems[1] != hostItems[3]);
+
+    // the first separator of every menu is the same action
+    QCOMPARE(clientMenu->actions().first(), hostItems[1]);
+
+    host.unmergeGroup(&client);
+    host.updateMenu(hostMenu);
+    QCOMPARE(hostMenu->actions(), QList<QAction *>({actions[0], hostItems[1], actions[1]}));
+    delete hostMenu;
+    delete clientMenu;
+}
+
+void TestQmdiActionGroup::mergedSeparatorsAreCopied() {
+    auto host = qmdiActionGroup("host");
+    auto client = new qmdiActionGroup("client");
+    auto actions = makeActions(2, this);
+    host.addAction(actions[0]);
+    client->addSeparator();
+    client->addAction(actions[1]);
+    host.mergeGroup(client);
+
+    // the client is destroyed without being un-merged
+    delete client;
+    auto menu = host.updateMenu();
+    QCOMPARE(menu->actions().size(), 3);
+    QVERIFY(menu->actions()[1]->isSeparator());
+    QCOMPARE(menu->actions()[2], actions[1]);
+    delete menu;
+}
+
+void TestQmdiActionGroup::overlayMatchesMerge() {
+    auto hostActions = makeActions(2, this);
+    auto merged = qmdiActionGroup("merged");
+    auto overlaid = qmdiActionGroup("overlaid");
+    for (auto host : {&merged, &overlaid}) {
+        host->addAction(hostActions[0]);
+        host->setMergePoint();
+        host->addAction(hostActions[1]);
+    }
+    auto client1 = qmdiActionGroup("client1");
+    auto client2 = qmdiActionGroup("client2");
+    auto clientActions = makeActions(3, this);
+    for (auto a : clientActions) {
+        client1.addAction(a);
+    }
+    client2.addAction(hostActions[1]);
+    client2.addAction(new QAction("client2", this));
+
+    merged.mergeGroup(&client1);
+    overlaid.setOverlay(&client1);
+    QVERIFY(!overlaid.containsAction(clientActions[0]));
+
+    auto mergedMenu = merged.updateMenu();
+    auto overlaidMenu = overlaid.updateMenu();
+    QCOMPARE(overlaidMenu->actions(), mergedMenu->actions());
+
+    merged.unmergeGroup(&client1);
+    merged.mergeGroup(&client2);
+    overlaid.setOverlay(&client2);
+    merged.updateMenu(mergedMenu);
+    overlaid.updateMenu(overlaidMenu);
+    QCOMPARE(overlaidMenu->actions(), mergedMenu->actions());
+
+    // modifying the overlay is visible in the group
+    client2.addAction(new QAction("late", this));
+    merged.unmergeGroup(&client2);
+    merged.mergeGroup(&client2);
+    merged.updateMenu(mergedMenu);
+    overlaid.updateMenu(overlaidMenu);
+    QCOMPARE(overlaidMenu->actions(), mergedMenu->actions());
+
+    overlaid.setOverlay(nullptr);
+    overlaid.updateMenu(overlaidMenu);
+    QCOMPARE(overlaidMenu->actions(), hostActions);
+    delete mergedMenu;
+    delete overlaidMenu;
+}
+
+void TestQmdiActionGroup::overlayShowsWidgets() {
+    auto parent = QWidget();
+    auto widget1 = new QWidget(&parent);
+    auto widget2 = new QWidget(&parent);
+    auto group = qmdiActionGroup("host");
+    auto client1 = qmdiActionGroup("host");
+    auto client2 = qmdiActionGroup("host");
+    client1.addWidget(widget1);
+    client2.addWidget(widget2);
+    widget1->hide();
+    widget2->hide();
+
+    group.setOverlay(&client1);
+    QVERIFY(!widget1->isHidden());
+    group.setOverlay(&client2);
+    QVERIFY(widget1->isHidden());
+    QVERIFY(!widget2->isHidden());
+    group.dropOverlay(&client2);
+    QVERIFY(widget2->isHidden());
+}
+
+void TestQmdiActionGroup::overlayKeepsListGroups() {
+    auto list = qmdiActionGroupList();
+    auto client = qmdiActionGroupList();
+    list["&File"];
+    client["&File"]->addAction(new QAction("open", this));
+    client["&Tools"];
+
+    // empty groups of the overlay are not added
+    list.setOverlay(&client);
+    QCOMPARE(list.size(), 1);
+    list.setOverlay(nullptr);
+
+    auto other = qmdiActionGroupList();
+    other["&Edit"]->addAction(new QAction("copy", this));
+    list.dropOverlay(&other);
+    QCOMPARE(list.size(), 1);
+}
+
+void TestQmdiActionGroup::layoutCreatesGroups() {
+    static constexpr auto layout = qmdiActionGroupLayout("&File", "&Edit", "&Help");
+    static_assert(layout.size() == 3);
+    static_assert(layout.slot("&Edit") == 1);
+    static_assert(layout.contains("&Edit"));
+    static_assert(!layout.contains("&Tools"));
+
+    auto list = qmdiActionGroupList();
+    auto edit = list["&Edit"];
+    auto groups = layout.apply(list);
+    QCOMPARE(list.size(), 3);
+    QCOMPARE(groups[1], edit);
+    QCOMPARE(groups[0], list["&File"]);
+    QCOMPARE(groups[2]->getName(), QString("&Help"));
+}
+
+void TestQmdiActionGroup::listFindsGroupsByName() {
+    auto list = qmdiActionGroupList();
+    auto file = list["&File"];
+    auto help = list["&Help"];
+    QCOMPARE(list["&File"], file);
+    QCOMPARE(list.size(), 2);
+
+    // duplicates are allowed, the first one in the list is found
+    auto secondHelp = list.addActionGroup("&Help", "&Help");
+    QVERIFY(secondHelp != help);
+    QCOMPARE(list["&Help"], help);
+    auto firstHelp = list.addActionGroup("&Help", "&File");
+    QCOMPARE(list["&Help"], firstHelp);
+    QCOMPARE(list.size(), 4);
+
+    // renamed groups are found by their new name
+    file->setName("&Document");
+    QCOMPARE(list["&Document"], file);
+    QVERIFY(list["&File"] != file);
+}
+
+void TestQmdiActionGroup::menuBarReusesMenus() {
+    auto list = qmdiActionGroupList();
+    auto actions = makeActions(3, this);
+    list["&File"]->addAction(actions[0]);
+    list["&Edit"];
+    list["&Help"]->addAction(actions[1]);
+
+    auto menubar = QMenuBar();
+    list.updateMenuBar(&menubar);
+    auto menus = menubar.actions();
+    QCOMPARE(menus.size(), 2);
+    QCOMPARE(menus[0]->menu()->actions(), QList<QAction *>({actions[0]}));
+
+    list["&Edit"]->addAction(actions[2]);
+    list.updateMenuBar(&menubar);
+    QCOMPARE(menubar.actions().size(), 3);
+    QCOMPARE(menubar.actions()[0], menus[0]);
+    QCOMPARE(menubar.actions()[2], menus[1]);
+    QCOMPARE(menubar.actions()[1]->menu()->actions(), QList<QAction *>({actions[2]}));
+
+    // empty groups are hidden, and their menu is re-used later
+    auto editMenu = menubar.actions()[1];
+    list["&Edit"]->removeAction(actions[2]);
+    list.updateMenuBar(&menubar);
+    QCOMPARE(menubar.actions(), menus);
+    list["&Edit"]->addAction(actions[2]);
+    list.updateMenuBar(&menubar);
+    QCOMPARE(menubar.actions()[1], editMenu);
+}
+
+void TestQmdiActionGroup::toolBarsFollowGroups() {
+    auto list = qmdiActionGroupList();
+    auto actions = makeActions(2, this);
+    list["main"]->addAction(actions[0]);
+    list["edit"]->addAction(actions[1]);
+
+    auto window = QMainWindow();
+    auto toolbars = list.updateToolBar(&window);
+    QCOMPARE(toolbars.size(), 2);
+    QCOMPARE(toolbars[0]->windowTitle(), QString("main"));
+
+    list["edit"]->setName("main");
+    QCOMPARE(list.updateToolBar(&window), toolbars);
+    QCOMPARE(toolbars[1]->windowTitle(), QString("main"));
+    QCOMPARE(toolbars[1]->actions(), QList<QAction *>({actions[1]}));
+}
+
+void TestQmdiActionGroup::toolBarsAreRenamed() {
+    auto list = qmdiActionGroupList();
+    list["main"]->addAction(new QAction("action", this));
+
+    auto window = QMainWindow();
+    auto toolbar = list.updateToolBar(&window).first();
+    QCOMPARE(toolbar->objectName(), QString("main"));
+
+    list["main"]->setName("tools");
+    QCOMPARE(list.updateToolBar(&window).first(), toolbar);
+    QCOMPARE(toolbar->objectName(), QString("tools"));
+    QCOMPARE(toolbar->windowTitle(), QString("tools"));
+}
+
+void TestQmdiActionGroup::popMenuReusesSubMenus() {
+    auto list = qmdiActionGroupList();
+    auto actions = makeActions(3, this);
+    list["&File"]->addAction(actions[0]);
+    list["&Edit"]->addAction(actions[1]);
+
+    auto popup = list.updatePopMenu(nullptr);
+    auto subMenus = popup->actions();
+    QCOMPARE(subMenus.size(), 2);
+    QCOMPARE(subMenus[0]->icon().cacheKey(), subMenus[1]->icon().cacheKey());
+
+    list["&Edit"]->addAction(actions[2]);
+    QCOMPARE(list.updatePopMenu(popup), popup);
+    QCOMPARE(popup->actions(), subMenus);
+    QCOMPARE(subMenus[1]->menu()->actions(), QList<QAction *>({actions[1], actions[2]}));
+    delete popup;
+}
+
+void TestQmdiActionGroup::namesAreInterned() {
+    auto file1 = qmdiActionGroup("&File");
+    auto file2 = qmdiActionGroup(QString("&Fi") + "le");
+    auto edit = qmdiActionGroup("&Edit");
+    QCOMPARE(file1.getNameAtom(), file2.getNameAtom());
+    QVERIFY(file1.getNameAtom() != edit.getNameAtom());
+
+    edit.setName("&File");
+    QCOMPARE(edit.getNameAtom(), file1.getNameAtom());
+}
+
+QTEST_MAIN(TestQmdiActionGroup)
+#include "actionGroupTests.moc"
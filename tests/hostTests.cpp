@@ -0,0 +1,446 @@
+#include <qmdiclient.h>
+#include <qmdihost.h>
+#include <qmditabwidget.h>
+
+#include <QAction>
+#include <QKeySequence>
+#include <QMainWindow>
+#include <QMenu>
+#include <QMenuBar>
+#include <QToolBar>
+#include <QtTest>
+
+#include "testHelpers.h"
+
+class TestQmdiHost : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void hostCountsWork();
+    void deferredUpdatesCoalesce();
+    void unchangedGUIIsNotRendered();
+    void mergeAttachesActionsOnce();
+    void sharedActionsAreCounted();
+    void deletedActionsAreForgotten();
+    void mergeTwiceIsIgnored();
+    void unmergeBackgroundClient();
+    void deleteBackgroundClient();
+    void updateBatchesChanges();
+    void hostDrivesManyWindows();
+    void widgetsOnlyInPrimaryWindow();
+    void shortcutConflictsAreIndexed();
+    void shortcutsSetByUserAreKept();
+};
+
+class WidgetClient : public QWidget, public qmdiClient {};
+class WindowHost : public QMainWindow, public qmdiHost {};
+
+class CountingClient : public qmdiClient {
+  public:
+    void on_client_merged(qmdiHost *host) override {
+        Q_UNUSED(host);
+        merged++;
+    }
+    void on_client_unmerged(qmdiHost *host) override {
+        Q_UNUSED(host);
+        unmerged++;
+    }
+
+    int merged = 0;
+    int unmerged = 0;
+};
+
+void TestQmdiHost::hostCountsWork() {
+    auto host = qmdiHost();
+    host.setStatsEnabled(true);
+    if (!host.getStatsEnabled()) {
+        QSKIP("statistics are compiled out");
+    }
+
+    auto window = QMainWindow();
+    host.menus["&File"]->addAction(new QAction("open", this));
+    auto client = qmdiClient();
+    for (auto a : makeActions(2, this)) {
+        client.menus["&File"]->addAction(a);
+    }
+    client.toolbars["main"]->addAction(new QAction("save", this));
+
+    host.mergeClient(&client);
+    host.updateGUI(&window);
+    host.updateGUI(&window);
+    auto stats = host.getStats();
+    QCOMPARE(stats.merges, quint64(1));
+    QCOMPARE(stats.itemsMoved, quint64(3));
+    QCOMPARE(stats.updateGUICalls, quint64(2));
+    QCOMPARE(stats.menusRebuilt, quint64(1));
+    QCOMPARE(stats.toolbarsRebuilt, quint64(1));
+
+    host.unmergeClient(&client);
+    QCOMPARE(host.getStats().unmerges, quint64(1));
+    QCOMPARE(host.getStats().itemsMoved, quint64(6));
+
+    host.resetStats();
+    QCOMPARE(host.getStats().merges, quint64(0));
+    host.setStatsEnabled(false);
+    host.mergeClient(&client);
+    QCOMPARE(host.getStats().merges, quint64(0));
+    host.unmergeClient(&client);
+}
+
+void TestQmdiHost::deferredUpdatesCoalesce() {
+    auto host = qmdiHost();
+    auto window = QMainWindow();
+    host.setDeferredUpdates(true);
+    host.menus["&File"]->addAction(new QAction("open", this));
+    host.updateGUI(&window);
+    host.updateGUI(&window);
+    QVERIFY(window.menuBar()->actions().isEmpty());
+
+    host.flushGUI();
+    QCOMPARE(window.menuBar()->actions().size(), 1);
+
+    host.menus["&Edit"]->addAction(new QAction("copy", this));
+    host.updateGUI(&window);
+    QCOMPARE(window.menuBar()->actions().size(), 1);
+    QTRY_COMPARE(window.menuBar()->actions().size(), 2);
+
+    // leaving deferred mode does the pending update
+    host.menus["&Help"]->addAction(new QAction("about", this));
+    host.updateGUI(&window);
+    host.setDeferredUpdates(false);
+    QCOMPARE(window.menuBar()->actions().size(), 3);
+}
+
+void TestQmdiHost::unchangedGUIIsNotRendered() {
+    auto host = WindowHost();
+    auto actions = makeActions(2, this);
+    host.menus["&File"]->addAction(actions[0]);
+    host.toolbars["main"]->addAction(actions[1]);
+    host.updateGUI();
+
+    auto menu = host.menuBar()->actions().first()->menu();
+    auto toolbar = host.findChild<QToolBar *>();
+    auto stray = new QAction("stray", this);
+    menu->addAction(stray);
+    toolbar->addAction(stray);
+
+    // nothing changed, the widgets are not touched
+    host.updateGUI();
+    QCOMPARE(host.menuBar()->actions().first()->menu(), menu);
+    QCOMPARE(host.findChild<QToolBar *>(), toolbar);
+    QCOMPARE(menu->actions(), QList<QAction *>({actions[0], stray}));
+    QCOMPARE(toolbar->actions(), QList<QAction *>({actions[1], stray}));
+
+    host.menus["&File"]->addAction(new QAction("save", this));
+    host.toolbars["main"]->removeAction(actions[1]);
+    host.updateGUI();
+    QVERIFY(!menu->actions().contains(stray));
+    QVERIFY(toolbar->actions().isEmpty());
+}
+
+void TestQmdiHost::mergeAttachesActionsOnce() {
+    auto host = qmdiHost();
+    auto client = WidgetClient();
+    auto other = new QAction("other", this);
+    client.addAction(other);
+    auto actions = makeActions(3, this);
+    client.menus["&File"]->addAction(actions[0]);
+    client.menus["&Edit"]->addAction(actions[1]);
+    client.toolbars["main"]->addAction(actions[0]);
+    client.toolbars["main"]->addAction(actions[2]);
+
+    host.mergeClient(&client);
+    QCOMPARE(client.actions().size(), 4);
+    QCOMPARE(client.actions().count(actions[0]), 1);
+
+    host.unmergeClient(&client);
+    QCOMPARE(client.actions(), QList<QAction *>({other}));
+}
+
+void TestQmdiHost::sharedActionsAreCounted() {
+    auto host = WindowHost();
+    auto own = new QAction("own", this);
+    host.addAction(own);
+    auto shared = new QAction("shared", this);
+    auto client1 = qmdiClient();
+    auto client2 = qmdiClient();
+    client1.menus["&Edit"]->addAction(shared);
+    client1.menus["&Edit"]->addAction(own);
+    client2.toolbars["main"]->addAction(shared);
+
+    host.mergeClients({&client1, &client2});
+    QCOMPARE(host.actions(), QList<QAction *>({own, shared}));
+
+    host.unmergeClient(&client1);
+    QCOMPARE(host.actions(), QList<QAction *>({own, shared}));
+
+    // actions attached by others are kept
+    host.unmergeClient(&client2);
+    QCOMPARE(host.actions(), QList<QAction *>({own}));
+}
+
+void TestQmdiHost::deletedActionsAreForgotten() {
+    auto host = WindowHost();
+    auto client1 = qmdiClient();
+    auto client2 = qmdiClient();
+    auto deleted = new QAction("deleted", this);
+    deleted->setShortcut(QKeySequence("Ctrl+D"));
+    client1.toolbars["main"]->addAction(deleted);
+    host.mergeClient(&client1);
+    client1.toolbars["main"]->removeAction(deleted);
+    host.toolbars["main"]->removeAction(deleted);
+    delete deleted;
+
+    // likely allocated where the deleted action was
+    auto action = new QAction("action", this);
+    action->setShortcut(QKeySequence("Ctrl+E"));
+    client2.menus["&File"]->addAction(action);
+    host.mergeClient(&client2);
+    QCOMPARE(host.actions(), QList<QAction *>({action}));
+    QCOMPARE(host.getShortcutActions(QKeySequence("Ctrl+E")), QList<QAction *>({action}));
+
+    {
+        auto guard = qmdiUpdateGuard(&host);
+        host.unmergeClient(&client2);
+    }
+    QVERIFY(host.actions().isEmpty());
+    host.unmergeClient(&client1);
+}
+
+void TestQmdiHost::mergeTwiceIsIgnored() {
+    auto host = WindowHost();
+    auto action = new QAction("action", this);
+    auto client = CountingClient();
+    client.menus["&File"]->addAction(action);
+
+    host.mergeClient(&client);
+    host.mergeClient(&client);
+    QCOMPARE(client.merged, 1);
+    host.updateGUI();
+    QCOMPARE(host.menuBar()->actions().first()->menu()->actions(), QList<QAction *>({action}));
+    QCOMPARE(host.actions(), QList<QAction *>({action}));
+
+    host.unmergeClient(&client);
+    QCOMPARE(client.unmerged, 1);
+    QVERIFY(host.actions().isEmpty());
+
+    // not merged anymore
+    host.unmergeClient(&client);
+    QCOMPARE(client.unmerged, 1);
+}
+
+void TestQmdiHost::unmergeBackgroundClient() {
+    auto host = WindowHost();
+    auto shared = new QAction("shared", this);
+    auto active = CountingClient();
+    auto background = CountingClient();
+    active.menus["&Edit"]->addAction(shared);
+    background.menus["&Edit"]->addAction(shared);
+
+    host.activateClient(&background);
+    host.activateClient(&active);
+    QCOMPARE(background.unmerged, 1);
+    QCOMPARE(host.actions(), QList<QAction *>({shared}));
+
+    // closing a tab in the background
+    host.unmergeClient(&background);
+    QCOMPARE(background.unmerged, 1);
+    QCOMPARE(host.getActiveClient(), &active);
+    QCOMPARE(host.actions(), QList<QAction *>({shared}));
+
+    host.unmergeClient(&active);
+    QCOMPARE(active.unmerged, 1);
+    QVERIFY(host.actions().isEmpty());
+}
+
+void TestQmdiHost::deleteBackgroundClient() {
+    auto host = WindowHost();
+    auto tabs = new qmdiTabWidget(&host, &host);
+    auto client1 = new WidgetClient;
+    auto client2 = new WidgetClient;
+    auto actions = makeActions(2, this);
+    client1->menus["&File"]->addAction(actions[0]);
+    client2->menus["&File"]->addAction(actions[1]);
+    client2->toolbars["main"]->addWidget(new QWidget(client2));
+
+    tabs->addTab(client1, "client1");
+    tabs->addTab(client2, "client2");
+    tabs->setCurrentIndex(1);
+    tabs->setCurrentIndex(0);
+    QCOMPARE(host.getActiveClient(), client1);
+    QCOMPARE(host.menus["&File"]->getOverlayCacheSize(), 2);
+
+    delete client2;
+    QCOMPARE(host.getActiveClient(), client1);
+    QCOMPARE(host.menus["&File"]->getOverlayCacheSize(), 1);
+    QCOMPARE(host.toolbars["main"]->getOverlayCacheSize(), 0);
+
+    delete client1;
+    QCOMPARE(host.menus["&File"]->getOverlayCacheSize(), 0);
+}
+
+void TestQmdiHost::updateBatchesChanges() {
+    auto host = WindowHost();
+    auto client1 = qmdiClient();
+    auto client2 = qmdiClient();
+    auto actions = makeActions(2, this);
+    client1.menus["&File"]->addAction(actions[0]);
+    client2.menus["&Edit"]->addAction(actions[1]);
+    host.mergeClient(&client1);
+    host.updateGUI();
+
+    {
+        auto outer = qmdiUpdateGuard(&host);
+        {
+            auto inner = qmdiUpdateGuard(&host);
+            host.unmergeClient(&client1);
+            host.mergeClient(&client2);
+            host.updateGUI();
+        }
+        QVERIFY(host.isUpdating());
+        QCOMPARE(host.actions(), QList<QAction *>({actions[0]}));
+        QCOMPARE(host.menuBar()->actions().size(), 1);
+        QCOMPARE(host.menuBar()->actions().first()->text(), QString("&File"));
+
+        // attaching again what is about to be detached
+        host.mergeClient(&client1);
+        host.unmergeClient(&client1);
+    }
+    QVERIFY(!host.isUpdating());
+    QCOMPARE(host.actions(), QList<QAction *>({actions[1]}));
+    QCOMPARE(host.menuBar()->actions().size(), 1);
+    QCOMPARE(host.menuBar()->actions().first()->text(), QString("&Edit"));
+}
+
+void TestQmdiHost::hostDrivesManyWindows() {
+    auto host = WindowHost();
+    auto second = new QMainWindow;
+    auto client = qmdiClient();
+    auto actions = makeActions(2, this);
+    client.menus["&File"]->addAction(actions[0]);
+    client.toolbars["main"]->addAction(actions[1]);
+
+    host.addWindow(second);
+    host.addWindow(&host);
+    QCOMPARE(host.getWindows(), QList<QMainWindow *>({&host, second}));
+
+    host.mergeClient(&client);
+    host.updateGUI();
+    QCOMPARE(second->actions(), actions);
+    auto menu1 = host.menuBar()->actions().first()->menu();
+    auto menu2 = second->menuBar()->actions().first()->menu();
+    QVERIFY(menu1 != menu2);
+    QCOMPARE(menu1->actions(), menu2->actions());
+    QCOMPARE(second->findChildren<QToolBar *>().size(), 1);
+
+    // a window added later gets the merged actions
+    auto third = QMainWindow();
+    host.addWindow(&third);
+    host.updateGUI();
+    QCOMPARE(third.actions().size(), 2);
+    QVERIFY(third.actions().contains(actions[0]));
+    QVERIFY(third.actions().contains(actions[1]));
+    QCOMPARE(third.menuBar()->actions().size(), 1);
+
+    delete second;
+    host.unmergeClient(&client);
+    host.updateGUI();
+    QCOMPARE(host.getWindows().size(), 2);
+    QVERIFY(third.actions().isEmpty());
+    QVERIFY(third.menuBar()->actions().isEmpty());
+    host.removeWindow(&third);
+}
+
+void TestQmdiHost::widgetsOnlyInPrimaryWindow() {
+    auto host = WindowHost();
+    auto second = QMainWindow();
+    auto client = qmdiClient();
+    auto action = new QAction("action", this);
+    auto widget = new QWidget;
+    client.toolbars["main"]->addAction(action);
+    client.toolbars["main"]->addWidget(widget);
+
+    host.addWindow(&second);
+    host.mergeClient(&client);
+    host.updateGUI();
+    auto toolbar1 = host.findChild<QToolBar *>();
+    auto toolbar2 = second.findChild<QToolBar *>();
+    QCOMPARE(toolbar1->actions().size(), 2);
+    QCOMPARE(toolbar2->actions(), QList<QAction *>({action}));
+    QCOMPARE(widget->parentWidget(), toolbar1);
+
+    host.unmergeClient(&client);
+    host.updateGUI();
+    QVERIFY(toolbar2->actions().isEmpty());
+    host.removeWindow(&second);
+}
+
+void TestQmdiHost::shortcutConflictsAreIndexed() {
+    auto host = qmdiHost();
+    auto copy = QKeySequence("Ctrl+C");
+    auto client1 = qmdiClient();
+    auto client2 = qmdiClient();
+    auto actions = makeActions(3, this);
+    actions[0]->setShortcut(copy);
+    actions[1]->setShortcut(copy);
+    actions[2]->setShortcut(QKeySequence("Ctrl+V"));
+    client1.menus["&Edit"]->addAction(actions[0]);
+    client1.toolbars["edit"]->addAction(actions[0]);
+    client2.menus["&Edit"]->addAction(actions[1]);
+    client2.menus["&Edit"]->addAction(actions[2]);
+
+    host.mergeClient(&client1);
+    QVERIFY(!host.hasShortcutConflict(copy));
+    host.mergeClient(&client2);
+    QVERIFY(host.hasShortcutConflict(copy));
+    QVERIFY(!host.hasShortcutConflict(QKeySequence("Ctrl+V")));
+    QCOMPARE(host.getShortcutConflicts(), QList<QKeySequence>({copy}));
+    QCOMPARE(host.getShortcutActions(copy), QList<QAction *>({actions[0], actions[1]}));
+
+    // the action merged last owns the shortcut
+    host.setShortcutRouting(true);
+    QVERIFY(actions[0]->shortcut().isEmpty());
+    QCOMPARE(actions[1]->shortcut(), copy);
+
+    host.unmergeClient(&client2);
+    QVERIFY(!host.hasShortcutConflict(copy));
+    QCOMPARE(actions[0]->shortcut(), copy);
+    QCOMPARE(actions[1]->shortcut(), copy);
+
+    host.unmergeClient(&client1);
+    QVERIFY(host.getShortcutActions(copy).isEmpty());
+}
+
+void TestQmdiHost::shortcutsSetByUserAreKept() {
+    auto host = qmdiHost();
+    auto copy = QKeySequence("Ctrl+C");
+    auto cut = QKeySequence("Ctrl+X");
+    auto client1 = qmdiClient();
+    auto client2 = qmdiClient();
+    auto actions = makeActions(2, this);
+    actions[0]->setShortcut(copy);
+    actions[1]->setShortcut(copy);
+    client1.menus["&Edit"]->addAction(actions[0]);
+    client2.menus["&Edit"]->addAction(actions[1]);
+
+    // without routing, the host never touches the shortcuts
+    host.activateClient(&client1);
+    actions[0]->setShortcut(cut);
+    host.activateClient(&client2);
+    QCOMPARE(actions[0]->shortcut(), cut);
+    host.activateClient(nullptr);
+    actions[0]->setShortcut(copy);
+
+    host.setShortcutRouting(true);
+    host.mergeClients({&client1, &client2});
+    QVERIFY(actions[0]->shortcut().isEmpty());
+    actions[0]->setShortcut(cut);
+    host.unmergeClient(&client2);
+    QCOMPARE(actions[0]->shortcut(), cut);
+    host.unmergeClient(&client1);
+    QCOMPARE(actions[0]->shortcut(), cut);
+    QCOMPARE(actions[1]->shortcut(), copy);
+}
+
+QTEST_MAIN(TestQmdiHost)
+#include "hostTests.moc"
@@ -0,0 +1,124 @@
+#include <qmdiactiongroup.h>
+#include <qmdiclient.h>
+#include <qmdihost.h>
+
+#include <QAction>
+#include <QApplication>
+#include <QMenu>
+#include <QToolBar>
+#include <QtTest>
+
+class MergeBenchmarks : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void nullRendererIsHeadless();
+    void mergeGroup();
+    void mergeClients();
+    void activateClients();
+
+  private:
+    qmdiClient *makeClient(int groups, int actions);
+
+    QList<qmdiClient *> clients;
+};
+
+void MergeBenchmarks::initTestCase() {
+    for (auto i = 0; i < 50; i++) {
+        clients << makeClient(5, 10);
+    }
+}
+
+void MergeBenchmarks::cleanupTestCase() { qDeleteAll(clients); }
+
+qmdiClient *MergeBenchmarks::makeClient(int groups, int actions) {
+    auto client = new qmdiClient;
+    for (auto g = 0; g < groups; g++) {
+        auto menu = client->menus[QString("menu %1").arg(g)];
+        auto toolbar = client->toolbars[QString("toolbar %1").arg(g)];
+        for (auto a = 0; a < actions; a++) {
+            auto action = new QAction(QString("action %1").arg(a), this);
+            menu->addAction(action);
+            if (a % 2 == 0) {
+                toolbar->addAction(action);
+            }
+        }
+        menu->addSeparator();
+    }
+    return client;
+}
+
+void MergeBenchmarks::nullRendererIsHeadless() {
+    auto topLevelWidgets = QApplication::topLevelWidgets().size();
+    auto widgets = QApplication::allWidgets().size();
+    auto host = qmdiHost();
+    auto renderer = qmdiNullRenderer();
+    host.addRenderer(&renderer);
+    host.mergeClient(clients[0]);
+    host.updateGUI();
+    host.updateGUI();
+    QCOMPARE(renderer.getMenusUpdates(), 1);
+    QCOMPARE(renderer.getToolBarsUpdates(), 1);
+
+    host.activateClient(clients[1]);
+    host.updateGUI();
+    QCOMPARE(renderer.getMenusUpdates(), 2);
+    host.unmergeClients({clients[0], clients[1]});
+    host.updateGUI();
+
+    // no widget was created to display the menus and toolbars
+    QCOMPARE(QApplication::topLevelWidgets().size(), topLevelWidgets);
+    QCOMPARE(QApplication::allWidgets().size(), widgets);
+    for (auto w : QApplication::allWidgets()) {
+        QVERIFY(!qobject_cast<QMenu *>(w));
+        QVERIFY(!qobject_cast<QToolBar *>(w));
+    }
+}
+
+void MergeBenchmarks::mergeGroup() {
+    auto group = qmdiActionGroup("host");
+    for (auto i = 0; i < 50; i++) {
+        group.addAction(new QAction(QString("host %1").arg(i), this));
+        if (i == 25) {
+            group.setMergePoint();
+        }
+    }
+    auto client = clients[0]->menus["menu 0"];
+
+    QBENCHMARK {
+        group.mergeGroup(client);
+        group.unmergeGroup(client);
+    }
+}
+
+void MergeBenchmarks::mergeClients() {
+    auto host = qmdiHost();
+    auto renderer = qmdiNullRenderer();
+    host.addRenderer(&renderer);
+
+    QBENCHMARK {
+        host.mergeClients(clients);
+        host.updateGUI();
+        host.unmergeClients(clients);
+        host.updateGUI();
+    }
+}
+
+void MergeBenchmarks::activateClients() {
+    auto host = qmdiHost();
+    auto renderer = qmdiNullRenderer();
+    host.addRenderer(&renderer);
+
+    QBENCHMARK {
+        for (auto client : std::as_const(clients)) {
+            host.activateClient(client);
+            host.updateGUI();
+        }
+    }
+    host.activateClient(nullptr);
+}
+
+QTEST_MAIN(MergeBenchmarks)
+#include "mergeBenchmarks.moc"
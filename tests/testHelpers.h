@@ -0,0 +1,13 @@
+#pragma once
+
+#include <QAction>
+#include <QList>
+#include <QString>
+
+inline QList<QAction *> makeActions(int count, QObject *parent) {
+    auto actions = QList<QAction *>();
+    for (auto i = 0; i < count; i++) {
+        actions << new QAction(QString("action %1").arg(i), parent);
+    }
+    return actions;
+}